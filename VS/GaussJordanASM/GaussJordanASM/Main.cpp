@@ -56,7 +56,14 @@ int main()
         run_test(size, Matrix::CPP_STANDARD, 1, "C++ Standard");
     }
 
-    // --- W tym miejscu będziesz dodawał testy C++ Multi-threaded i ASM SIMD ---
+    // Testowanie implementacji ASM SIMD (jądro wybrane przez CPUID)
+    std::string asm_name = std::string("ASM SIMD (") + Matrix::asm_kernel_name() + ")";
+    for (int size : sizes)
+    {
+        run_test(size, Matrix::ASM_SIMD, 1, asm_name);
+    }
+
+    // --- W tym miejscu będziesz dodawał testy C++ Multi-threaded ---
 
     std::cout << "----------------------------------------------------------------------\n";
     
@@ -6,16 +6,112 @@
 #include <random>
 #include <iomanip>
 #include <thread>
+#include <algorithm>
 
-Matrix::Matrix(int n) : size(n), columns(n + 1)
+#if defined(_M_X64)
+#include <intrin.h>
+
+// Jądra z pliku row_update_x64.asm
+extern "C" {
+    void gj_row_update_sse2(double* dst, const double* src, size_t count, double factor);
+    void gj_row_update_avx2(double* dst, const double* src, size_t count, double factor);
+    void gj_row_update_avx512(double* dst, const double* src, size_t count, double factor);
+}
+#endif
+
+namespace
+{
+    using RowUpdateFn = void (*)(double* dst, const double* src, size_t count, double factor);
+
+    struct AsmKernel
+    {
+        RowUpdateFn fn;
+        const char* name;
+    };
+
+    // Wybór najszerszego wariantu, który obsługuje procesor ORAZ system
+    // (CPUID mówi co ma rdzeń, XCR0 - które rejestry system zapisuje przy przełączaniu wątków)
+    AsmKernel detect_asm_kernel()
+    {
+#if defined(_M_X64)
+        int info[4];
+        __cpuid(info, 1);
+        bool sse2 = (info[3] & (1 << 26)) != 0;
+        bool fma = (info[2] & (1 << 12)) != 0;
+        bool osxsave = (info[2] & (1 << 27)) != 0;
+        bool avx = (info[2] & (1 << 28)) != 0;
+
+        bool avx2 = false, avx512f = false;
+        if (osxsave && avx)
+        {
+            unsigned long long xcr0 = _xgetbv(0);
+            bool ymm_state = (xcr0 & 0x6) == 0x6;
+            bool zmm_state = (xcr0 & 0xe6) == 0xe6;
+
+            __cpuid(info, 0);
+            if (info[0] >= 7)
+            {
+                __cpuidex(info, 7, 0);
+                avx2 = ymm_state && fma && (info[1] & (1 << 5)) != 0;
+                avx512f = zmm_state && (info[1] & (1 << 16)) != 0;
+            }
+        }
+
+        if (avx512f) return { gj_row_update_avx512, "AVX-512" };
+        if (avx2) return { gj_row_update_avx2, "AVX2" };
+        if (sse2) return { gj_row_update_sse2, "SSE2" };
+#endif
+        return { nullptr, "brak" };
+    }
+
+    const AsmKernel& asm_kernel()
+    {
+        static const AsmKernel kernel = detect_asm_kernel();
+        return kernel;
+    }
+}
+
+const char* Matrix::asm_kernel_name()
+{
+    return asm_kernel().name;
+}
+
+Matrix::Matrix(int n, int rhs) : size(n), rhs(rhs), columns(n + rhs)
 {
     if (n <= 0) {
         throw std::invalid_argument("Rozmiar macierzy musi byc wiekszy niz 0.");
     }
-    // Alokacja pamięci dla spłaszczonej macierzy (N * (N+1) elementów typu double)
+    if (rhs <= 0) {
+        throw std::invalid_argument("Liczba kolumn prawej strony musi byc wieksza niz 0.");
+    }
+    // Alokacja pamięci dla spłaszczonej macierzy (N * (N+K) elementów typu double)
     data.resize(size * columns);
 }
 
+void Matrix::set_identity_rhs()
+{
+    if (rhs != size) {
+        throw std::invalid_argument("Macierz odwrotna wymaga rhs == n.");
+    }
+    for (int i = 0; i < size; ++i) {
+        for (int j = 0; j < rhs; ++j) {
+            at(i, size + j) = (i == j) ? 1.0 : 0.0;
+        }
+    }
+}
+
+std::vector<double> Matrix::solution_block() const
+{
+    // Po eliminacji część A jest macierzą jednostkową, a w części B zostaje X
+    std::vector<double> x(size * rhs);
+    for (int i = 0; i < size; ++i) {
+        for (int j = 0; j < rhs; ++j) {
+            x[i * rhs + j] = at(i, size + j);
+        }
+    }
+    return x;
+}
+
 void Matrix::generate_random()
 {
     std::random_device rd;
@@ -55,6 +151,18 @@ void Matrix::subtract_row_single_thread(int dest_row, int src_row, double factor
     }
 }
 
+// Ta sama operacja co wyżej, ale przez jądro ASM SIMD
+void Matrix::subtract_row_simd(int dest_row, int src_row, double factor)
+{
+    RowUpdateFn fn = asm_kernel().fn;
+    if (fn == nullptr) {
+        // Brak jądra ASM (np. kompilacja Win32) - wracamy do wersji C++
+        subtract_row_single_thread(dest_row, src_row, factor);
+        return;
+    }
+    fn(&data[dest_row * columns], &data[src_row * columns], (size_t)columns, factor);
+}
+
 // Główna funkcja eliminacji (część pętli eliminacji)
 void Matrix::perform_elimination(int start_row, int end_row, int pivot_col, double factor, int implementation_id)
 {
@@ -76,8 +184,11 @@ void Matrix::elimination_worker(int start_row, int end_row, int pivot_row, doubl
             // Współczynnik dla wiersza i
             double current_factor = at(i, pivot_row);
 
-            // Wywołujemy krytyczną operację (obecnie bazowa wersja C++)
-            subtract_row_single_thread(i, pivot_row, current_factor);
+            // Wywołujemy krytyczną operację (C++ lub ASM SIMD)
+            if (impl == ASM_SIMD)
+                subtract_row_simd(i, pivot_row, current_factor);
+            else
+                subtract_row_single_thread(i, pivot_row, current_factor);
 
             // Ustawienie elementu na 0, aby macierz była w czystej postaci Gaussa-Jordana
             at(i, pivot_row) = 0.0;
@@ -148,6 +259,19 @@ double Matrix::eliminate(ImplementationType impl, int num_threads)
                 }
             }
         }
+        else if (impl == ASM_SIMD)
+        {
+            // Wersja ASM SIMD (jednowątkowa) - jądro wybrane raz przez CPUID
+            for (int i = 0; i < size; ++i)
+            {
+                if (i != k)
+                {
+                    double factor = at(i, k);
+                    subtract_row_simd(i, k, factor);
+                    at(i, k) = 0.0;
+                }
+            }
+        }
         else if (impl == CPP_MULTITHREAD)
         {
             // Wersja WIELOWĄTKOWA - Dzielimy CAŁĄ pracę eliminacji na wątki
@@ -10,12 +10,16 @@ class Matrix
 {
 private:
     std::vector<double> data; // Spłaszczona macierz 1D dla lepszej wydajności i ASM
-    int size;                // Liczba wierszy (macierz N x N+1)
-    int columns;             // Liczba kolumn (N + 1)
+    int size;                // Liczba wierszy (macierz N x N+K)
+    int rhs;                 // Liczba kolumn prawej strony K (1 = jeden wektor b, N = macierz odwrotna)
+    int columns;             // Liczba kolumn (N + K)
 
     // Funkcja wykonująca kluczową operację na wierszach (do zastąpienia przez ASM)
     void subtract_row_single_thread(int dest_row, int src_row, double factor);
 
+    // Ta sama operacja w asemblerze (row_update_x64.asm), wariant SSE2/AVX2/AVX-512 wybierany przez CPUID
+    void subtract_row_simd(int dest_row, int src_row, double factor);
+
     // Nowa wersja, która będzie mogła wywołać implementację C++ lub ASM
     void perform_elimination(int start_row, int end_row, int pivot_col, double factor, int implementation_id);
 
@@ -23,8 +27,21 @@ public:
     // 1 - C++ Standard; 2 - C++ Multi-Threaded; 3 - ASM SIMD
     enum ImplementationType { CPP_STANDARD, CPP_MULTITHREAD, ASM_SIMD };
 
-    Matrix(int n);
+private:
+    // Eliminacja dla zakresu wierszy [start_row, end_row) - funkcja wątku roboczego
+    void elimination_worker(int start_row, int end_row, int pivot_row, double factor_unused, ImplementationType impl);
+
+public:
+
+    // [A | B] z rhs kolumnami prawej strony (domyślnie jeden wektor b)
+    Matrix(int n, int rhs = 1);
     void generate_random();
+
+    // Wpisuje macierz jednostkową w część B ([A | I]) - wymaga rhs == n; po eliminacji B = A^-1
+    void set_identity_rhs();
+
+    // Blok rozwiązania X (N x K, wierszami) - wołać po eliminate()
+    std::vector<double> solution_block() const;
     void print() const;
 
     // Główna funkcja wykonująca Eliminację Gaussa-Jordana
@@ -33,6 +50,9 @@ public:
     // Metoda pomocnicza do pobrania liczby procesorów logicznych
     static int get_logical_processors() { return (int)std::thread::hardware_concurrency(); }
 
+    // Nazwa jądra ASM wybranego przez CPUID ("SSE2", "AVX2", "AVX-512" lub "brak")
+    static const char* asm_kernel_name();
+
     // Dostęp do elementów (R, C)
     double& at(int r, int c) { return data[r * columns + c]; }
     const double& at(int r, int c) const { return data[r * columns + c]; }
@@ -0,0 +1,137 @@
+; Jądra aktualizacji wiersza dla eliminacji Gaussa-Jordana (x64, MASM, ABI Windows x64)
+;
+;   void gj_row_update_<isa>(double* dst, const double* src, size_t count, double factor)
+;
+;   dst[j] -= factor * src[j]   dla j = 0 .. count-1
+;
+;   rcx = dst, rdx = src, r8 = count, xmm3 = factor
+;
+; Używamy tylko rejestrów ulotnych (xmm0-xmm5, k1), więc nie trzeba niczego zapisywać na stosie.
+; Wiersze w Matrix nie są wyrównane, dlatego wszystkie odczyty/zapisy są "unaligned".
+
+.code
+
+; ------------------------------------------------------------------ SSE2
+gj_row_update_sse2 PROC
+    unpcklpd xmm3, xmm3                 ; factor w obu połówkach
+    mov     r9, r8
+    shr     r9, 2                       ; 4 liczby double na iterację
+    jz      sse2_tail
+sse2_loop:
+    movupd  xmm0, XMMWORD PTR [rdx]
+    movupd  xmm1, XMMWORD PTR [rdx+16]
+    mulpd   xmm0, xmm3
+    mulpd   xmm1, xmm3
+    movupd  xmm4, XMMWORD PTR [rcx]
+    movupd  xmm5, XMMWORD PTR [rcx+16]
+    subpd   xmm4, xmm0
+    subpd   xmm5, xmm1
+    movupd  XMMWORD PTR [rcx], xmm4
+    movupd  XMMWORD PTR [rcx+16], xmm5
+    add     rdx, 32
+    add     rcx, 32
+    dec     r9
+    jnz     sse2_loop
+sse2_tail:
+    and     r8, 3
+    jz      sse2_done
+sse2_tail_loop:
+    movsd   xmm0, QWORD PTR [rdx]
+    mulsd   xmm0, xmm3
+    movsd   xmm1, QWORD PTR [rcx]
+    subsd   xmm1, xmm0
+    movsd   QWORD PTR [rcx], xmm1
+    add     rdx, 8
+    add     rcx, 8
+    dec     r8
+    jnz     sse2_tail_loop
+sse2_done:
+    ret
+gj_row_update_sse2 ENDP
+
+; ------------------------------------------------------------------ AVX2 + FMA
+gj_row_update_avx2 PROC
+    vbroadcastsd ymm3, xmm3
+    mov     r9, r8
+    shr     r9, 3                       ; 8 liczb double na iterację
+    jz      avx2_tail
+avx2_loop:
+    vmovupd ymm0, YMMWORD PTR [rdx]
+    vmovupd ymm1, YMMWORD PTR [rdx+32]
+    vmovupd ymm4, YMMWORD PTR [rcx]
+    vmovupd ymm5, YMMWORD PTR [rcx+32]
+    vfnmadd231pd ymm4, ymm3, ymm0       ; ymm4 -= factor * src
+    vfnmadd231pd ymm5, ymm3, ymm1
+    vmovupd YMMWORD PTR [rcx], ymm4
+    vmovupd YMMWORD PTR [rcx+32], ymm5
+    add     rdx, 64
+    add     rcx, 64
+    dec     r9
+    jnz     avx2_loop
+avx2_tail:
+    and     r8, 7
+    jz      avx2_done
+avx2_tail_loop:
+    vmovsd  xmm0, QWORD PTR [rdx]
+    vmovsd  xmm4, QWORD PTR [rcx]
+    vfnmadd231sd xmm4, xmm3, xmm0
+    vmovsd  QWORD PTR [rcx], xmm4
+    add     rdx, 8
+    add     rcx, 8
+    dec     r8
+    jnz     avx2_tail_loop
+avx2_done:
+    vzeroupper
+    ret
+gj_row_update_avx2 ENDP
+
+; ------------------------------------------------------------------ AVX-512F
+gj_row_update_avx512 PROC
+    vbroadcastsd zmm3, xmm3
+    mov     r9, r8
+    shr     r9, 4                       ; 16 liczb double na iterację
+    jz      avx512_rest
+avx512_loop:
+    vmovupd zmm0, ZMMWORD PTR [rdx]
+    vmovupd zmm1, ZMMWORD PTR [rdx+64]
+    vmovupd zmm4, ZMMWORD PTR [rcx]
+    vmovupd zmm5, ZMMWORD PTR [rcx+64]
+    vfnmadd231pd zmm4, zmm3, zmm0
+    vfnmadd231pd zmm5, zmm3, zmm1
+    vmovupd ZMMWORD PTR [rcx], zmm4
+    vmovupd ZMMWORD PTR [rcx+64], zmm5
+    add     rdx, 128
+    add     rcx, 128
+    dec     r9
+    jnz     avx512_loop
+avx512_rest:
+    and     r8, 15
+    jz      avx512_done
+    cmp     r8, 8
+    jb      avx512_masked
+    vmovupd zmm0, ZMMWORD PTR [rdx]     ; jeden pełny rejestr z reszty
+    vmovupd zmm4, ZMMWORD PTR [rcx]
+    vfnmadd231pd zmm4, zmm3, zmm0
+    vmovupd ZMMWORD PTR [rcx], zmm4
+    add     rdx, 64
+    add     rcx, 64
+    sub     r8, 8
+    jz      avx512_done
+avx512_masked:
+    mov     r9, rcx                     ; zostało 1..7 elementów: k1 = (1 << r8) - 1
+    mov     ecx, r8d
+    mov     eax, 1
+    shl     eax, cl
+    dec     eax
+    kmovw   k1, eax
+    mov     rcx, r9
+    vmovupd zmm0 {k1}{z}, ZMMWORD PTR [rdx]
+    vmovupd zmm4 {k1}{z}, ZMMWORD PTR [rcx]
+    vfnmadd231pd zmm4, zmm3, zmm0
+    vmovupd ZMMWORD PTR [rcx] {k1}, zmm4
+avx512_done:
+    vzeroupper
+    ret
+gj_row_update_avx512 ENDP
+
+END
@@ -0,0 +1,261 @@
+// Reproducible benchmark sweep over matrix sizes, thread counts and solver
+// engines. Every configuration is warmed up, then timed `reps` times on a fresh
+// copy of the same seeded system; the results go out as CSV or JSON so runs of
+// different releases can be diffed.
+//
+//   Asembler2_bench [--sizes 64,512,1024] [--threads 1,2,4] [--rhs K]
+//                   [--engines seq,par,lookahead,lu,mixed,tiled] [--kernel NAME]
+//                   [--reps R] [--warmup W] [--seed S] [--block N]
+//                   [--format csv|json] [--out FILE]
+//
+// GFLOP/s is computed from the LU operation count 2/3 n^3 + 2 n^2 rhs for every
+// engine, so it compares time-to-solution rather than work done (Gauss-Jordan
+// performs about 1.5x the operations of LU). The sequential solver is always
+// measured, as it is the baseline of the speedup column.
+
+#include "src_gauss_jordan.h"
+#include "src_lu.h"
+#include "src_mixed.h"
+#include "src_stats.h"
+#include "src_tiled_lu.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Options {
+    std::vector<int> sizes{64, 512, 1024};
+    std::vector<int> threads;
+    std::vector<std::string> engines{"seq", "par", "lookahead", "lu", "mixed", "tiled"};
+    RowKernel kernel = RowKernel::Auto;
+    int rhs = 1;
+    int reps = 5;
+    int warmup = 1;
+    int blockSize = 64;
+    uint64_t seed = 12345;
+    std::string format = "csv";
+    std::string out;
+};
+
+struct Result {
+    int n;
+    std::string engine;
+    int threads;
+    double medianMs;
+    double p95Ms;
+    double minMs;
+    double gflops;
+    double speedup;
+    double residual;
+};
+
+std::vector<int> parseIntList(const std::string &s) {
+    std::vector<int> values;
+    std::stringstream in(s);
+    std::string item;
+    while (std::getline(in, item, ',')) {
+        try {
+            int v = std::stoi(item);
+            if (v > 0) values.push_back(v);
+        } catch (...) {
+            throw std::runtime_error("Bad number in list: " + s);
+        }
+    }
+    return values;
+}
+
+std::vector<std::string> parseNameList(const std::string &s) {
+    std::vector<std::string> values;
+    std::stringstream in(s);
+    std::string item;
+    while (std::getline(in, item, ',')) {
+        if (!item.empty()) values.push_back(item);
+    }
+    return values;
+}
+
+std::vector<int> defaultThreadCounts() {
+    unsigned hw = std::thread::hardware_concurrency();
+    int maxThreads = hw > 0 ? static_cast<int>(hw) : 1;
+    std::vector<int> counts;
+    for (int t = 1; t < maxThreads; t *= 2) counts.push_back(t);
+    counts.push_back(maxThreads);
+    return counts;
+}
+
+bool isThreaded(const std::string &engine) { return engine == "par" || engine == "lookahead" || engine == "tiled"; }
+
+// Solve `m` in place with the given engine
+std::function<void(Matrix &)> makeEngine(const std::string &engine, const Options &opt, int threads) {
+    RowKernel kernel = opt.kernel;
+    int block = opt.blockSize;
+    unsigned tc = static_cast<unsigned>(threads);
+    if (engine == "seq") return [kernel](Matrix &m) { gaussJordanSequential(m, kernel); };
+    if (engine == "par") return [kernel, tc](Matrix &m) { gaussJordanParallel(m, tc, kernel); };
+    if (engine == "lookahead") return [kernel, tc](Matrix &m) { gaussJordanParallel(m, tc, kernel, 1); };
+    if (engine == "lu") return [block](Matrix &m) { luSolveBlocked(m, block); };
+    if (engine == "mixed") return [block](Matrix &m) { solveMixedPrecision(m, 0.0, 30, block); };
+    if (engine == "tiled") return [tc, block](Matrix &m) { luSolveTiled(m, tc, block); };
+    throw std::runtime_error("Unknown engine: " + engine);
+}
+
+Result measure(const Matrix &orig, const std::string &engine, int threads, const Options &opt) {
+    auto solve = makeEngine(engine, opt, threads);
+    Matrix work;
+    for (int i = 0; i < opt.warmup; ++i) {
+        work = orig;
+        solve(work);
+    }
+    std::vector<double> times;
+    for (int i = 0; i < opt.reps; ++i) {
+        work = orig;
+        auto t0 = std::chrono::steady_clock::now();
+        solve(work);
+        auto t1 = std::chrono::steady_clock::now();
+        times.push_back(std::chrono::duration<double, std::milli>(t1 - t0).count());
+    }
+    std::sort(times.begin(), times.end());
+
+    Result r;
+    r.n = orig.n;
+    r.engine = engine;
+    r.threads = threads;
+    r.medianMs = median(times);
+    r.p95Ms = percentile(times, 0.95);
+    r.minMs = times.front();
+    double n = orig.n;
+    double flops = 2.0 / 3.0 * n * n * n + 2.0 * n * n * orig.rhs;
+    r.gflops = flops / (r.medianMs * 1e6);
+    r.speedup = 0.0;
+    r.residual = residualNorm(orig, work);
+    return r;
+}
+
+void writeCsv(std::ostream &out, const std::vector<Result> &results, const Options &opt) {
+    out << "n,rhs,engine,threads,kernel,reps,median_ms,p95_ms,min_ms,gflops,speedup,residual\n";
+    out.precision(6);
+    for (const Result &r : results) {
+        out << r.n << ',' << opt.rhs << ',' << r.engine << ',' << r.threads << ','
+            << rowKernelName(opt.kernel) << ',' << opt.reps << ',' << r.medianMs << ',' << r.p95Ms << ','
+            << r.minMs << ',' << r.gflops << ',' << r.speedup << ',' << r.residual << '\n';
+    }
+}
+
+void writeJson(std::ostream &out, const std::vector<Result> &results, const Options &opt) {
+    out.precision(6);
+    out << "{\n  \"config\": {\"seed\": " << opt.seed << ", \"rhs\": " << opt.rhs << ", \"reps\": " << opt.reps
+        << ", \"warmup\": " << opt.warmup << ", \"block\": " << opt.blockSize << ", \"kernel\": \""
+        << rowKernelName(opt.kernel) << "\", \"hardware_threads\": " << std::thread::hardware_concurrency()
+        << ", \"compiler\": \"" << __VERSION__ << "\"},\n  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result &r = results[i];
+        out << "    {\"n\": " << r.n << ", \"engine\": \"" << r.engine << "\", \"threads\": " << r.threads
+            << ", \"median_ms\": " << r.medianMs << ", \"p95_ms\": " << r.p95Ms << ", \"min_ms\": " << r.minMs
+            << ", \"gflops\": " << r.gflops << ", \"speedup\": " << r.speedup << ", \"residual\": " << r.residual
+            << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    Options opt;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string a = argv[i];
+            bool hasValue = i + 1 < argc;
+            if (a == "--sizes" && hasValue) {
+                opt.sizes = parseIntList(argv[++i]);
+            } else if (a == "--threads" && hasValue) {
+                opt.threads = parseIntList(argv[++i]);
+            } else if (a == "--engines" && hasValue) {
+                opt.engines = parseNameList(argv[++i]);
+            } else if (a == "--kernel" && hasValue) {
+                if (!parseRowKernel(argv[++i], opt.kernel))
+                    throw std::runtime_error(std::string("Unknown kernel: ") + argv[i]);
+            } else if (a == "--rhs" && hasValue) {
+                opt.rhs = std::max(1, std::stoi(argv[++i]));
+            } else if (a == "--reps" && hasValue) {
+                opt.reps = std::max(1, std::stoi(argv[++i]));
+            } else if (a == "--warmup" && hasValue) {
+                opt.warmup = std::max(0, std::stoi(argv[++i]));
+            } else if (a == "--block" && hasValue) {
+                opt.blockSize = std::max(1, std::stoi(argv[++i]));
+            } else if (a == "--seed" && hasValue) {
+                opt.seed = std::stoull(argv[++i]);
+            } else if (a == "--format" && hasValue) {
+                opt.format = argv[++i];
+                if (opt.format != "csv" && opt.format != "json")
+                    throw std::runtime_error("Unknown format: " + opt.format);
+            } else if (a == "--out" && hasValue) {
+                opt.out = argv[++i];
+            } else {
+                std::cout << "Usage: " << argv[0]
+                          << " [--sizes 64,512,1024] [--threads 1,2,4] [--rhs K]"
+                          << " [--engines seq,par,lookahead,lu,mixed,tiled] [--kernel cpp|sse2|avx2|avx512|auto]"
+                          << " [--reps R] [--warmup W] [--seed S] [--block N] [--format csv|json] [--out FILE]\n";
+                return a == "--help" ? 0 : 1;
+            }
+        }
+        for (const std::string &e : opt.engines) makeEngine(e, opt, 1); // reject unknown names up front
+    } catch (const std::exception &ex) {
+        std::cerr << ex.what() << "\n";
+        return 1;
+    }
+    if (opt.threads.empty()) opt.threads = defaultThreadCounts();
+    if (opt.kernel == RowKernel::Auto) opt.kernel = bestRowKernel();
+    if (!rowKernelSupported(opt.kernel)) {
+        std::cerr << "Kernel " << rowKernelName(opt.kernel) << " is not supported on this machine\n";
+        return 1;
+    }
+
+    std::vector<Result> results;
+    for (int n : opt.sizes) {
+        // One fixed system per size, identical for every engine and every run
+        Matrix orig(n, opt.rhs);
+        orig.fillRandom(-10.0, 10.0, opt.seed + static_cast<uint64_t>(n));
+
+        std::cerr << "n = " << n << ": seq\n";
+        Result baseline = measure(orig, "seq", 1, opt);
+        baseline.speedup = 1.0;
+        bool baselineListed = false;
+
+        for (const std::string &engine : opt.engines) {
+            if (engine == "seq") {
+                results.push_back(baseline);
+                baselineListed = true;
+                continue;
+            }
+            std::vector<int> counts = isThreaded(engine) ? opt.threads : std::vector<int>{1};
+            for (int t : counts) {
+                std::cerr << "n = " << n << ": " << engine << " x" << t << "\n";
+                Result r = measure(orig, engine, t, opt);
+                r.speedup = baseline.medianMs / r.medianMs;
+                results.push_back(r);
+            }
+        }
+        if (!baselineListed) results.push_back(baseline);
+    }
+
+    std::ofstream file;
+    if (!opt.out.empty()) {
+        file.open(opt.out);
+        if (!file) {
+            std::cerr << "Cannot write " << opt.out << "\n";
+            return 1;
+        }
+    }
+    std::ostream &out = opt.out.empty() ? std::cout : file;
+    if (opt.format == "json") writeJson(out, results, opt);
+    else writeCsv(out, results, opt);
+    return 0;
+}
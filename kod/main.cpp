@@ -1,6 +1,23 @@
 #include "src_gauss_jordan.h"
+#include "src_banded.h"
+#include "src_batched.h"
+#include "src_lu.h"
+#include "src_matrix_gen.h"
+#include "src_matrix_io.h"
+#include "src_factor_cache.h"
+#include "src_fixed_solve.h"
+#include "src_mixed.h"
+#include "src_numa.h"
+#include "src_out_of_core.h"
+#include "src_solve_service.h"
+#include "src_thread_pool.h"
+#include "src_tiled_lu.h"
 #include <chrono>
+#include <cstdio>
+#include <future>
 #include <iostream>
+#include <random>
+#include <limits>
 #include <string>
 #include <algorithm>
 #include <thread>
@@ -16,16 +33,233 @@ static int parseIntOrDefault(const char *s, int def) {
     }
 }
 
+// Banded solver vs. the dense blocked LU on the same banded system
+static int runBanded(int size, int band, int rhs, int blockSize) {
+    std::cout << "Banded solve (n = " << size << ", lower = upper = " << band << ", rhs = " << rhs << ")\n";
+    BandMatrix orig(size, band, band, rhs);
+    orig.fillRandom(-10.0, 10.0, 12345);
+
+    BandMatrix work = orig;
+    auto t0 = std::chrono::high_resolution_clock::now();
+    bandedSolve(work);
+    auto t1 = std::chrono::high_resolution_clock::now();
+    std::cout << "Band storage time: " << std::chrono::duration<double, std::milli>(t1 - t0).count()
+              << " ms, residual = " << work.residualNorm(orig) << "\n";
+
+    Matrix dense = orig.toDense();
+    Matrix detected = dense;
+    auto t2 = std::chrono::high_resolution_clock::now();
+    Bandwidth found = detectBandwidth(detected);
+    solveBanded(detected, found);
+    auto t3 = std::chrono::high_resolution_clock::now();
+    std::cout << "Dense input, detected band " << found.lower << "/" << found.upper << ": "
+              << std::chrono::duration<double, std::milli>(t3 - t2).count()
+              << " ms, residual = " << residualNorm(dense, detected) << "\n";
+
+    Matrix full = dense;
+    auto t4 = std::chrono::high_resolution_clock::now();
+    luSolveBlocked(full, blockSize);
+    auto t5 = std::chrono::high_resolution_clock::now();
+    std::cout << "Dense blocked LU time: " << std::chrono::duration<double, std::milli>(t5 - t4).count()
+              << " ms, residual = " << residualNorm(dense, full) << "\n";
+    return 0;
+}
+
+// Out-of-core solve of the system in `path` (written first, row by row, if missing)
+static int runOutOfCore(const std::string &path, int size, int rhs, size_t budgetBytes, RowKernel kernel,
+                        const std::string &solutionPath) {
+    try {
+        if (FILE *f = std::fopen(path.c_str(), "rb")) {
+            std::fclose(f);
+        } else {
+            std::cout << "Writing random system (n = " << size << ", rhs = " << rhs << ") to " << path << "...\n";
+            saveRandomSystem(size, rhs, -10.0, 10.0, 12345, path);
+        }
+        OutOfCoreOptions options;
+        options.memoryBudget = budgetBytes;
+        options.kernel = kernel;
+        OutOfCoreStats st;
+        auto t0 = std::chrono::high_resolution_clock::now();
+        std::vector<double> x = solveOutOfCore(path, options, &st);
+        auto t1 = std::chrono::high_resolution_clock::now();
+        std::cout << "Out-of-core solve (n = " << st.n << ", rhs = " << st.rhs << ", " << st.panels
+                  << " panels of " << st.panelWidth << " columns): "
+                  << std::chrono::duration<double, std::milli>(t1 - t0).count() << " ms\n";
+        std::cout << "  copy " << st.copyMs << " ms, factor " << st.factorMs << " ms, solve " << st.solveMs
+                  << " ms, waiting for reads " << st.ioWaitMs << " ms\n";
+        std::cout << "  read " << st.bytesRead / (1 << 20) << " MiB, written " << st.bytesWritten / (1 << 20)
+                  << " MiB\n";
+        if (!solutionPath.empty()) saveSolution(x, st.n, st.rhs, solutionPath);
+
+        Matrix orig = loadMatrix(path); // mapped: pages stream through for the residual
+        std::vector<double> r;
+        std::cout << "  residual ||AX-B|| = " << residualBlock(orig, x, r) << "\n";
+    } catch (const std::exception &ex) {
+        std::cerr << ex.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
+
+// `count` fixed-size solves of N x N systems vs. gaussJordanSequential on Matrix
+template <int N>
+static void runFixed(int count) {
+    std::vector<FixedMatrix<N>> systems(count);
+    for (int s = 0; s < count; ++s) fillRandom(systems[s], -10.0, 10.0, 12345 + s);
+
+    std::vector<FixedMatrix<N>> fixed = systems;
+    auto t0 = std::chrono::high_resolution_clock::now();
+    for (FixedMatrix<N> &m : fixed) solve(m);
+    auto t1 = std::chrono::high_resolution_clock::now();
+
+    std::vector<Matrix> dynamic;
+    dynamic.reserve(count);
+    for (const FixedMatrix<N> &m : systems) dynamic.push_back(toMatrix(m));
+    auto t2 = std::chrono::high_resolution_clock::now();
+    for (Matrix &m : dynamic) gaussJordanSequential(m);
+    auto t3 = std::chrono::high_resolution_clock::now();
+
+    double worst = 0.0;
+    for (int s = 0; s < count; ++s) worst = std::max(worst, residualNorm(systems[s], fixed[s]));
+    double ns_fixed = std::chrono::duration<double, std::nano>(t1 - t0).count() / count;
+    double ns_dynamic = std::chrono::duration<double, std::nano>(t3 - t2).count() / count;
+    std::cout << "n = " << N << ": fixed " << ns_fixed << " ns, Matrix " << ns_dynamic
+              << " ns per solve, worst residual " << worst << "\n";
+}
+
+static int runFixedSizes(int count) {
+    std::cout << "Fixed-size solve<N> vs. gaussJordanSequential (" << count << " systems each)\n";
+    try {
+        runFixed<2>(count);
+        runFixed<3>(count);
+        runFixed<4>(count);
+        runFixed<8>(count);
+        runFixed<16>(count);
+    } catch (const std::exception &ex) {
+        std::cerr << ex.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
+
+// `requests` systems from 4 concurrent callers through one SolveService:
+// mostly 16 x 16 (batched), every 20th one `size` x `size` (whole pool)
+static int runService(int requests, int size, unsigned threadCount, RowKernel kernel) {
+    SolveServiceOptions options;
+    options.threads = threadCount;
+    options.kernel = kernel;
+    SolveService service(options);
+    std::cout << "Solve service: " << requests << " requests from 4 callers (16 x 16, every 20th " << size << " x "
+              << size << ")\n";
+
+    const int callers = 4;
+    std::vector<double> worst(callers, 0.0);
+    std::vector<std::thread> clients;
+    auto t0 = std::chrono::high_resolution_clock::now();
+    for (int c = 0; c < callers; ++c) {
+        clients.emplace_back([&, c]() {
+            std::vector<Matrix> systems;
+            std::vector<std::future<Matrix>> results;
+            for (int r = c; r < requests; r += callers) {
+                Matrix m(r % 20 == 19 ? size : 16, 1);
+                m.fillRandom(-10.0, 10.0, 12345 + r);
+                systems.push_back(m);
+                results.push_back(service.submit(std::move(m)));
+            }
+            for (size_t i = 0; i < results.size(); ++i) {
+                Matrix solved = results[i].get();
+                worst[c] = std::max(worst[c], residualNorm(systems[i], solved));
+            }
+        });
+    }
+    for (std::thread &t : clients) t.join();
+    auto t1 = std::chrono::high_resolution_clock::now();
+
+    SolveServiceStats st = service.stats();
+    std::cout << "Total time: " << std::chrono::duration<double, std::milli>(t1 - t0).count() << " ms, worst residual "
+              << *std::max_element(worst.begin(), worst.end()) << "\n";
+    std::cout << "  " << st.completed << " solved, " << st.batched << " in " << st.batches << " batches, queue depth "
+              << st.queueDepth << "\n";
+    std::cout << "  latency p50 " << st.p50Ms << " ms, p95 " << st.p95Ms << " ms, p99 " << st.p99Ms << " ms, max "
+              << st.maxMs << " ms\n";
+    return 0;
+}
+
+// Batched solver vs. one gaussJordanSequential call per system
+static int runBatch(int count, int size, int rhs, unsigned threadCount) {
+    std::cout << "Batched Gauss-Jordan (" << count << " systems, n = " << size << ", rhs = " << rhs << ")\n";
+    MatrixBatch orig(count, size, rhs);
+    orig.fillRandom(12345);
+
+    auto t0 = std::chrono::high_resolution_clock::now();
+    for (int s = 0; s < count; ++s) {
+        Matrix m = orig.system(s);
+        gaussJordanSequential(m);
+    }
+    auto t1 = std::chrono::high_resolution_clock::now();
+
+    MatrixBatch work = orig;
+    auto t2 = std::chrono::high_resolution_clock::now();
+    gaussJordanBatched(work, threadCount);
+    auto t3 = std::chrono::high_resolution_clock::now();
+
+    double ms_loop = std::chrono::duration<double, std::milli>(t1 - t0).count();
+    double ms_batch = std::chrono::duration<double, std::milli>(t3 - t2).count();
+    std::cout << "One-by-one time: " << ms_loop << " ms\n";
+    std::cout << "Batched time: " << ms_batch << " ms, worst residual = " << maxResidualNorm(orig, work) << "\n";
+    return 0;
+}
+
 int main(int argc, char **argv) {
     // default parameters
     int size = 256;         // default matrix dimension (n)
     unsigned threadCount = 0; // 0 -> auto detect hardware_concurrency
     bool runParallel = true;
+    RowKernel kernel = RowKernel::Cpp;
+    bool runLU = false;
+    bool runMixed = false;
+    bool runTiled = false;
+    int blockSize = 64;
+    int rhs = 1;
+    int cacheRepeats = 0;
+    int batchCount = 0;
+    int fixedCount = 0;
+    int serviceRequests = 0;
+    int lookahead = 0;
+    int band = -1;
+    std::string loadPath, savePath, solutionPath, oocPath;
+    size_t budgetMB = 1024;
+    bool profileRuns = false;
+    bool numaPlacement = false;
+    MatrixGenOptions genOptions;
+    uint64_t seed = std::random_device{}();
 
     // simple CLI:
     // --size N
     // --threads N   (0 = auto)
     // --seq          run sequential version only
+    // --kernel NAME  row-update kernel: cpp, sse2, avx2, avx512, auto
+    // --lu           also run the blocked LU solver
+    // --block N      LU block size (default 64)
+    // --tiled        also run the tiled LU task graph on the work-stealing scheduler (tile = --block)
+    // --mixed        also run the float LU + double iterative refinement solver
+    // --rhs K        number of right-hand-side columns solved in one pass
+    // --cache R      solve the same A with R fresh right-hand sides through FactorizationCache
+    // --batch C      solve C independent n x n systems with the batched (SIMD across systems) solver
+    // --serve R      R requests from concurrent callers through the asynchronous SolveService
+    // --fixed R      R solves per size with the compile-time sized solve<N> (n = 2, 3, 4, 8, 16)
+    // --lookahead D  also run the pipelined parallel schedule with lookahead depth D
+    // --band B       banded system with lower = upper = B: band solver vs dense LU
+    // --load FILE    solve the system stored in FILE (binary format, see src_matrix_io.h)
+    // --save FILE    write the generated system to FILE
+    // --matrix KIND  generated system: dense (default), banded, spd, illcond
+    // --seed S       seed of the generated system (default: random, printed)
+    // --cond C       condition number of an illcond system (default 1e8)
+    // --solution FILE write the sequential solution X to FILE
+    // --ooc FILE     out-of-core solve of FILE (a random --size system is written first if FILE is missing)
+    // --budget MB    memory budget for the out-of-core panels (default 1024)
+    // --numa         pin parallel workers to NUMA nodes and first-touch their rows there
+    // --profile      print per-phase/per-thread profiles as JSON (needs -DGJ_ENABLE_PROFILING=ON)
     for (int i = 1; i < argc; ++i) {
         std::string a = argv[i];
         if (a == "--size" && i + 1 < argc) {
@@ -34,16 +268,118 @@ int main(int argc, char **argv) {
             threadCount = static_cast<unsigned>(parseIntOrDefault(argv[++i], 0));
         } else if (a == "--seq") {
             runParallel = false;
+        } else if (a == "--kernel" && i + 1 < argc) {
+            if (!parseRowKernel(argv[++i], kernel)) {
+                std::cerr << "Unknown kernel: " << argv[i] << "\n";
+                return 1;
+            }
+        } else if (a == "--lu") {
+            runLU = true;
+        } else if (a == "--tiled") {
+            runTiled = true;
+        } else if (a == "--mixed") {
+            runMixed = true;
+        } else if (a == "--block" && i + 1 < argc) {
+            blockSize = parseIntOrDefault(argv[++i], blockSize);
+        } else if (a == "--rhs" && i + 1 < argc) {
+            rhs = std::max(1, parseIntOrDefault(argv[++i], rhs));
+        } else if (a == "--cache" && i + 1 < argc) {
+            cacheRepeats = std::max(0, parseIntOrDefault(argv[++i], 0));
+        } else if (a == "--batch" && i + 1 < argc) {
+            batchCount = std::max(0, parseIntOrDefault(argv[++i], 0));
+        } else if (a == "--serve" && i + 1 < argc) {
+            serviceRequests = std::max(0, parseIntOrDefault(argv[++i], 0));
+        } else if (a == "--fixed" && i + 1 < argc) {
+            fixedCount = std::max(0, parseIntOrDefault(argv[++i], 0));
+        } else if (a == "--band" && i + 1 < argc) {
+            band = std::max(0, parseIntOrDefault(argv[++i], 0));
+        } else if (a == "--load" && i + 1 < argc) {
+            loadPath = argv[++i];
+        } else if (a == "--matrix" && i + 1 < argc) {
+            if (!parseMatrixKind(argv[++i], genOptions.kind)) {
+                std::cerr << "Unknown matrix kind: " << argv[i] << "\n";
+                return 1;
+            }
+        } else if (a == "--seed" && i + 1 < argc) {
+            try {
+                seed = std::stoull(argv[++i]);
+            } catch (...) {
+                std::cerr << "Invalid seed: " << argv[i] << "\n";
+                return 1;
+            }
+        } else if (a == "--cond" && i + 1 < argc) {
+            try {
+                genOptions.condition = std::stod(argv[++i]);
+            } catch (...) {
+                std::cerr << "Invalid condition number: " << argv[i] << "\n";
+                return 1;
+            }
+        } else if (a == "--save" && i + 1 < argc) {
+            savePath = argv[++i];
+        } else if (a == "--solution" && i + 1 < argc) {
+            solutionPath = argv[++i];
+        } else if (a == "--ooc" && i + 1 < argc) {
+            oocPath = argv[++i];
+        } else if (a == "--budget" && i + 1 < argc) {
+            budgetMB = static_cast<size_t>(std::max(1, parseIntOrDefault(argv[++i], 1024)));
+        } else if (a == "--numa") {
+            numaPlacement = true;
+        } else if (a == "--profile") {
+            profileRuns = true;
+        } else if (a == "--lookahead" && i + 1 < argc) {
+            lookahead = std::max(0, parseIntOrDefault(argv[++i], 0));
         } else if (a == "--help") {
-            std::cout << "Usage: " << argv[0] << " [--size N] [--threads N] [--seq]\n";
+            std::cout << "Usage: " << argv[0]
+                      << " [--size N] [--threads N] [--seq] [--kernel cpp|sse2|avx2|avx512|auto]"
+                      << " [--lu] [--tiled] [--mixed] [--block N] [--rhs K] [--cache R] [--batch C] [--fixed R] [--serve R] [--lookahead D] [--band B] [--load FILE] [--save FILE] [--matrix dense|banded|spd|illcond] [--seed S] [--cond C] [--solution FILE] [--ooc FILE] [--budget MB] [--numa] [--profile]\n";
             return 0;
         }
     }
 
-    std::cout << "Gauss-Jordan benchmark (n = " << size << ")\n";
+    if (kernel == RowKernel::Auto) kernel = bestRowKernel();
+    if (!rowKernelSupported(kernel)) {
+        std::cerr << "Kernel " << rowKernelName(kernel) << " is not supported on this machine\n";
+        return 1;
+    }
 
-    Matrix orig(size);
-    orig.fillRandom();
+    if (!oocPath.empty()) {
+        return runOutOfCore(oocPath, size, rhs, budgetMB << 20, kernel, solutionPath);
+    }
+    if (band >= 0) {
+        return runBanded(size, band, rhs, blockSize);
+    }
+    if (serviceRequests > 0) {
+        return runService(serviceRequests, size, threadCount, kernel);
+    }
+    if (fixedCount > 0) {
+        return runFixedSizes(fixedCount);
+    }
+    if (batchCount > 0) {
+        return runBatch(batchCount, size, rhs, threadCount);
+    }
+
+    Matrix orig;
+    try {
+        if (!loadPath.empty()) {
+            orig = loadMatrix(loadPath); // mapped, not parsed
+            size = orig.n;
+            rhs = orig.rhs;
+        } else {
+            auto g0 = std::chrono::high_resolution_clock::now();
+            orig = Matrix(size, rhs);
+            fillSystem(orig, MatrixGenerator(size, rhs, seed, genOptions), threadCount);
+            auto g1 = std::chrono::high_resolution_clock::now();
+            std::cout << "Generated " << matrixKindName(genOptions.kind) << " system (seed " << seed << ") in "
+                      << std::chrono::duration<double, std::milli>(g1 - g0).count() << " ms\n";
+        }
+        if (!savePath.empty()) saveMatrix(orig, savePath);
+    } catch (const std::exception &ex) {
+        std::cerr << ex.what() << "\n";
+        return 1;
+    }
+
+    std::cout << "Gauss-Jordan benchmark (n = " << size << ", rhs = " << rhs
+              << ", kernel = " << rowKernelName(kernel) << ")\n";
 
     // Work on copies because the algorithm modifies the matrix in-place
     Matrix Aseq = orig;
@@ -51,9 +387,10 @@ int main(int argc, char **argv) {
 
     // Sequential run
     std::cout << "Running sequential Gauss-Jordan...\n";
+    SolveProfile seqProfile, parProfile, laProfile;
     auto t0 = std::chrono::high_resolution_clock::now();
     try {
-        gaussJordanSequential(Aseq);
+        gaussJordanSequential(Aseq, kernel, profileRuns ? &seqProfile : nullptr);
     } catch (const std::exception &ex) {
         std::cerr << "Error in sequential: " << ex.what() << "\n";
         return 1;
@@ -63,6 +400,95 @@ int main(int argc, char **argv) {
     double res_seq = residualNorm(orig, Aseq);
     std::cout << std::fixed << std::setprecision(20);
     std::cout << "Sequential time: " << ms_seq << " ms, residual ||Ax-b|| = " << res_seq << "\n";
+    if (!solutionPath.empty()) {
+        try {
+            saveSolution(Aseq, solutionPath);
+        } catch (const std::exception &ex) {
+            std::cerr << ex.what() << "\n";
+            return 1;
+        }
+    }
+
+    if (runLU) {
+        Matrix Alu = orig;
+        double normA1 = norm1(orig);
+        std::cout << "Running blocked LU (block " << blockSize << ")...\n";
+        auto t4 = std::chrono::high_resolution_clock::now();
+        try {
+            luSolveBlocked(Alu, blockSize);
+        } catch (const std::exception &ex) {
+            std::cerr << "Error in blocked LU: " << ex.what() << "\n";
+            return 1;
+        }
+        auto t5 = std::chrono::high_resolution_clock::now();
+        double ms_lu = std::chrono::duration<double, std::milli>(t5 - t4).count();
+        double res_lu = residualNorm(orig, Alu);
+        std::cout << "Blocked LU time: " << ms_lu << " ms, residual ||Ax-b|| = " << res_lu << "\n";
+        double cond = luConditionEstimate(Alu, normA1);
+        std::cout << "Condition estimate ||A||_1 ||A^-1||_1 ~ " << std::scientific << std::setprecision(3) << cond
+                  << ", relative forward error <~ " << cond * std::numeric_limits<double>::epsilon()
+                  << ", compensated residual = " << residualNorm(orig, Alu, Summation::Compensated) << "\n"
+                  << std::fixed << std::setprecision(20);
+    }
+
+    if (runTiled) {
+        Matrix Atile = orig;
+        std::cout << "Running tiled LU task graph (tile " << blockSize << ")...\n";
+        SchedulerStats stats;
+        auto t4 = std::chrono::high_resolution_clock::now();
+        try {
+            stats = luSolveTiled(Atile, threadCount, blockSize);
+        } catch (const std::exception &ex) {
+            std::cerr << "Error in tiled LU: " << ex.what() << "\n";
+            return 1;
+        }
+        auto t5 = std::chrono::high_resolution_clock::now();
+        double ms_tile = std::chrono::duration<double, std::milli>(t5 - t4).count();
+        std::cout << "Tiled LU time: " << ms_tile << " ms (" << stats.tasks << " tasks, " << stats.steals
+                  << " steals), residual ||Ax-b|| = " << residualNorm(orig, Atile) << "\n";
+    }
+
+    if (runMixed) {
+        Matrix Amix = orig;
+        std::cout << "Running mixed-precision LU (float factors, double refinement)...\n";
+        MixedSolveInfo info;
+        auto t4 = std::chrono::high_resolution_clock::now();
+        try {
+            info = solveMixedPrecision(Amix, 0.0, 30, blockSize);
+        } catch (const std::exception &ex) {
+            std::cerr << "Error in mixed precision: " << ex.what() << "\n";
+            return 1;
+        }
+        auto t5 = std::chrono::high_resolution_clock::now();
+        double ms_mix = std::chrono::duration<double, std::milli>(t5 - t4).count();
+        std::cout << "Mixed precision time: " << ms_mix << " ms, " << info.refinementSteps
+                  << " refinement steps" << (info.fellBack ? " (fell back to double)" : "")
+                  << ", residual ||Ax-b|| = " << residualNorm(orig, Amix) << "\n";
+    }
+
+    if (cacheRepeats > 0) {
+        FactorizationCache cache(size_t(1) << 30, blockSize);
+        Matrix system = orig;
+        double ms_total = 0.0, worst_res = 0.0;
+        std::cout << "Running " << cacheRepeats << " cached solves of the same A...\n";
+        for (int r = 0; r < cacheRepeats; ++r) {
+            // keep A, draw a fresh B
+            Matrix fresh(size, rhs);
+            fresh.fillRandom();
+            for (int i = 0; i < size; ++i)
+                for (int c = 0; c < rhs; ++c) system.at(i, size + c) = fresh.at(i, size + c);
+            Matrix work = system;
+            auto tc0 = std::chrono::high_resolution_clock::now();
+            cache.solve(work);
+            auto tc1 = std::chrono::high_resolution_clock::now();
+            double ms = std::chrono::duration<double, std::milli>(tc1 - tc0).count();
+            ms_total += ms;
+            if (r == 0) std::cout << "First (miss) time: " << ms << " ms\n";
+            worst_res = std::max(worst_res, residualNorm(system, work));
+        }
+        std::cout << "Cached solves: " << cache.hits() << " hits, " << cache.misses()
+                  << " misses, avg " << ms_total / cacheRepeats << " ms, worst residual " << worst_res << "\n";
+    }
 
     if (runParallel) {
         if (threadCount == 0) {
@@ -70,10 +496,17 @@ int main(int argc, char **argv) {
             threadCount = hw > 0 ? hw : 1;
         }
         std::cout << "Running parallel Gauss-Jordan with " << threadCount << " threads...\n";
+        ThreadPool *pinned = nullptr;
+        if (numaPlacement) {
+            pinned = &ThreadPool::shared(threadCount, ThreadPlacement::Pinned);
+            std::cout << "Pinned to " << NumaTopology::system().describe() << ", rows first-touched per worker\n";
+            Apar = copyFirstTouch(orig, *pinned);
+        }
 
         auto t2 = std::chrono::high_resolution_clock::now();
         try {
-            gaussJordanParallel(Apar, threadCount);
+            if (pinned) gaussJordanParallel(Apar, *pinned, kernel, 0, profileRuns ? &parProfile : nullptr);
+            else gaussJordanParallel(Apar, threadCount, kernel, 0, profileRuns ? &parProfile : nullptr);
         } catch (const std::exception &ex) {
             std::cerr << "Error in parallel: " << ex.what() << "\n";
             return 1;
@@ -84,6 +517,29 @@ int main(int argc, char **argv) {
         std::cout << std::fixed << std::setprecision(20);
         std::cout << "Parallel time: " << ms_par << " ms, residual ||Ax-b|| = " << res_par << "\n";
 
+        if (lookahead > 0) {
+            Matrix Ala = pinned ? copyFirstTouch(orig, *pinned) : orig;
+            auto t4 = std::chrono::high_resolution_clock::now();
+            try {
+                if (pinned) gaussJordanParallel(Ala, *pinned, kernel, lookahead, profileRuns ? &laProfile : nullptr);
+                else gaussJordanParallel(Ala, threadCount, kernel, lookahead, profileRuns ? &laProfile : nullptr);
+            } catch (const std::exception &ex) {
+                std::cerr << "Error in lookahead: " << ex.what() << "\n";
+                return 1;
+            }
+            auto t5 = std::chrono::high_resolution_clock::now();
+            double ms_la = std::chrono::duration<double, std::milli>(t5 - t4).count();
+            std::cout << "Lookahead (depth " << lookahead << ") time: " << ms_la
+                      << " ms, residual ||Ax-b|| = " << residualNorm(orig, Ala) << "\n";
+        }
+    }
+
+    if (profileRuns) {
+        if (!seqProfile.enabled) std::cerr << "Profiling is compiled out; rebuild with -DGJ_ENABLE_PROFILING=ON\n";
+        std::cout << "{\"sequential\": " << seqProfile.toJson();
+        if (runParallel) std::cout << ",\n \"parallel\": " << parProfile.toJson();
+        if (runParallel && lookahead > 0) std::cout << ",\n \"lookahead\": " << laProfile.toJson();
+        std::cout << "}\n";
     }
 
     return 0;
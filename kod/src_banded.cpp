@@ -0,0 +1,174 @@
+#include "src_banded.h"
+#include "src_matrix_gen.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+Bandwidth detectBandwidth(const Matrix &matrix) {
+    Bandwidth band;
+    int n = matrix.n;
+    for (int i = 0; i < n; ++i) {
+        const double *a = matrix.row(i);
+        int first = 0;
+        while (first < i && a[first] == 0.0) ++first;
+        int last = n - 1;
+        while (last > i && a[last] == 0.0) --last;
+        band.lower = std::max(band.lower, i - first);
+        band.upper = std::max(band.upper, last - i);
+    }
+    return band;
+}
+
+BandMatrix::BandMatrix(int size, int lowerBand, int upperBand, int rhsCount)
+    : n(size), lower(lowerBand), upper(upperBand), rhs(rhsCount), width_(2 * lowerBand + upperBand + 1) {
+    if (size < 0 || lowerBand < 0 || upperBand < 0 || rhsCount < 0) {
+        throw std::invalid_argument("Band sizes and number of right-hand sides must be >= 0.");
+    }
+    band_.assign(static_cast<size_t>(n) * width_, 0.0);
+    b_.assign(static_cast<size_t>(n) * rhs, 0.0);
+}
+
+BandMatrix::BandMatrix(const Matrix &dense, Bandwidth band)
+    : BandMatrix(dense.n, band.lower, band.upper, dense.rhs) {
+    for (int i = 0; i < n; ++i) {
+        const double *a = dense.row(i);
+        for (int j = 0; j < n; ++j) {
+            if (j - i >= -lower && j - i <= upper) {
+                window(i)[slot(i, j)] = a[j];
+            } else if (a[j] != 0.0) {
+                throw std::invalid_argument("Matrix has a non-zero outside the given band.");
+            }
+        }
+        std::copy(a + n, a + n + rhs, b_.begin() + static_cast<size_t>(i) * rhs);
+    }
+}
+
+double BandMatrix::get(int r, int c) const {
+    if (c - r < -lower || c - r > upper + lower) return 0.0;
+    return window(r)[slot(r, c)];
+}
+
+void BandMatrix::set(int r, int c, double value) {
+    if (c - r < -lower || c - r > upper) throw std::out_of_range("Element outside the band.");
+    window(r)[slot(r, c)] = value;
+}
+
+void BandMatrix::fillRandom(double low, double high, uint64_t seed) {
+    // Entry by entry from the counter-based generator: with lower == upper
+    // this is MatrixGenerator's Banded system, without an n x n row buffer
+    for (int i = 0; i < n; ++i) {
+        double row_abs_sum = 0.0;
+        int c0 = std::max(0, i - lower), c1 = std::min(n - 1, i + upper);
+        for (int j = c0; j <= c1; ++j) {
+            double v = philoxUniform(seed, kPhiloxStreamEntries, i, j, low, high);
+            window(i)[slot(i, j)] = v;
+            row_abs_sum += std::fabs(v);
+        }
+        window(i)[slot(i, i)] += row_abs_sum + 1.0;
+        for (int c = 0; c < rhs; ++c) b(i, c) = philoxUniform(seed, kPhiloxStreamEntries, i, n + c, low, high);
+    }
+}
+
+Matrix BandMatrix::toDense() const {
+    Matrix m(n, rhs);
+    for (int i = 0; i < n; ++i) {
+        double *a = m.row(i);
+        int c0 = std::max(0, i - lower), c1 = std::min(n - 1, i + upper + lower);
+        for (int j = c0; j <= c1; ++j) a[j] = window(i)[slot(i, j)];
+        for (int c = 0; c < rhs; ++c) a[n + c] = b(i, c);
+    }
+    return m;
+}
+
+double BandMatrix::residualNorm(const BandMatrix &orig) const {
+    if (orig.n != n || orig.rhs != rhs) return -1.0;
+    double sumsq = 0.0;
+    std::vector<double> s(rhs);
+    for (int i = 0; i < n; ++i) {
+        std::fill(s.begin(), s.end(), 0.0);
+        int c0 = std::max(0, i - orig.lower), c1 = std::min(n - 1, i + orig.upper);
+        for (int j = c0; j <= c1; ++j) {
+            double a = orig.get(i, j);
+            for (int c = 0; c < rhs; ++c) s[c] += a * b(j, c);
+        }
+        for (int c = 0; c < rhs; ++c) {
+            double r = s[c] - orig.b(i, c);
+            sumsq += r * r;
+        }
+    }
+    return std::sqrt(sumsq);
+}
+
+void bandedSolve(BandMatrix &m) {
+    const int n = m.n;
+    const int kl = m.lower;
+    const int reach = m.upper + m.lower; // last column a pivot row can touch, relative to its index
+    const int rhs = m.rhs;
+
+    for (int k = 0; k < n; ++k) {
+        // partial pivot among the rows that reach column k
+        int last_row = std::min(n - 1, k + kl);
+        int pivot_row = k;
+        double maxval = std::abs(m.window(k)[m.slot(k, k)]);
+        for (int i = k + 1; i <= last_row; ++i) {
+            double v = std::abs(m.window(i)[m.slot(i, k)]);
+            if (v > maxval) {
+                maxval = v;
+                pivot_row = i;
+            }
+        }
+        if (maxval < 1e-15) {
+            throw std::runtime_error("Matrix is singular or nearly singular (pivot ~ 0).");
+        }
+
+        int last_col = std::min(n - 1, k + reach);
+        int len = last_col - k + 1;
+        double *rk = m.window(k) + m.slot(k, k);
+        if (pivot_row != k) {
+            // Both windows cover columns [k, k + reach], at different offsets
+            double *rp = m.window(pivot_row) + m.slot(pivot_row, k);
+            std::swap_ranges(rk, rk + len, rp);
+            double *bk = m.b_.data() + static_cast<size_t>(k) * rhs;
+            std::swap_ranges(bk, bk + rhs, m.b_.data() + static_cast<size_t>(pivot_row) * rhs);
+        }
+
+        double inv_pivot = 1.0 / rk[0];
+        for (int i = k + 1; i <= last_row; ++i) {
+            double *ri = m.window(i) + m.slot(i, k);
+            double l = ri[0] * inv_pivot;
+            if (l == 0.0) continue;
+            ri[0] = 0.0;
+            for (int j = 1; j < len; ++j) ri[j] -= l * rk[j];
+            for (int c = 0; c < rhs; ++c) m.b(i, c) -= l * m.b(k, c);
+        }
+    }
+
+    // U X = Y, U has `reach` superdiagonals
+    for (int i = n - 1; i >= 0; --i) {
+        const double *ri = m.window(i) + m.slot(i, i);
+        int last_col = std::min(n - 1, i + reach);
+        for (int j = i + 1; j <= last_col; ++j) {
+            double u = ri[j - i];
+            if (u == 0.0) continue;
+            for (int c = 0; c < rhs; ++c) m.b(i, c) -= u * m.b(j, c);
+        }
+        double inv = 1.0 / ri[0];
+        for (int c = 0; c < rhs; ++c) m.b(i, c) *= inv;
+    }
+}
+
+void solveBanded(Matrix &matrix) {
+    solveBanded(matrix, detectBandwidth(matrix));
+}
+
+void solveBanded(Matrix &matrix, Bandwidth band) {
+    int n = matrix.n;
+    if (n == 0) return;
+    BandMatrix work(matrix, band);
+    bandedSolve(work);
+    const std::vector<double> &x = work.solutionBlock();
+    for (int i = 0; i < n; ++i) {
+        std::copy(x.begin() + static_cast<size_t>(i) * matrix.rhs,
+                  x.begin() + static_cast<size_t>(i + 1) * matrix.rhs, matrix.row(i) + n);
+    }
+}
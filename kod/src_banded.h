@@ -0,0 +1,83 @@
+#ifndef SRC_BANDED_H
+#define SRC_BANDED_H
+
+#include <cstdint>
+#include <vector>
+#include "src_gauss_jordan.h"
+
+// Band of a matrix: A[i][j] can be non-zero only for -lower <= j - i <= upper
+struct Bandwidth {
+    int lower = 0;
+    int upper = 0;
+};
+
+// Smallest band that holds every non-zero of the A part (O(n^2) scan)
+Bandwidth detectBandwidth(const Matrix &matrix);
+
+// Banded system [A|B] in O(n * (2*lower + upper + 1)) memory.
+//
+// Row i keeps the window of columns [i - lower, i + upper + lower]: the band
+// itself plus the `lower` extra superdiagonals that partial pivoting can fill
+// in (the layout of LAPACK's gbtrf, stored by rows instead of columns so that
+// row updates stay contiguous as in the dense solvers). B is kept apart,
+// n x rhs, row-major.
+class BandMatrix {
+public:
+    int n;
+    int lower;
+    int upper;
+    int rhs;
+
+    BandMatrix(int size = 0, int lowerBand = 0, int upperBand = 0, int rhsCount = 1);
+
+    // Copy of [A|B]; throws std::invalid_argument if A has a non-zero outside `band`
+    BandMatrix(const Matrix &dense, Bandwidth band);
+
+    // Element (r, c) of A; zero outside the band
+    double get(int r, int c) const;
+    // Set element (r, c) of A; throws std::out_of_range outside the band
+    void set(int r, int c, double value);
+
+    double &b(int r, int c) { return b_[static_cast<size_t>(r) * rhs + c]; }
+    double b(int r, int c) const { return b_[static_cast<size_t>(r) * rhs + c]; }
+
+    // Random entries inside the band, diagonally dominant like Matrix::fillRandom
+    // (the same values as MatrixGenerator's Banded kind when lower == upper)
+    void fillRandom(double low, double high, uint64_t seed);
+
+    // Dense copy of [A|B] (for the dense solvers and residualNorm)
+    Matrix toDense() const;
+
+    // B, or X once bandedSolve() has run (n x rhs, row-major)
+    const std::vector<double> &solutionBlock() const { return b_; }
+
+    // ||A*X - B||_F against the original system `orig`; O(n * band * rhs)
+    double residualNorm(const BandMatrix &orig) const;
+
+private:
+    friend void bandedSolve(BandMatrix &matrix);
+
+    int width_; // 2*lower + upper + 1
+    std::vector<double> band_;
+    std::vector<double> b_;
+
+    double *window(int r) { return band_.data() + static_cast<size_t>(r) * width_; }
+    const double *window(int r) const { return band_.data() + static_cast<size_t>(r) * width_; }
+    // Index of column c inside the window of row r
+    int slot(int r, int c) const { return c - r + lower; }
+};
+
+// Banded LU with partial pivoting, forward elimination of B on the fly and
+// back substitution: B is replaced by X, A by its (row-permuted) U factor.
+// The pivot search covers `lower` rows and every update `lower + upper`
+// columns, so the cost is O(n * lower * (lower + upper)) instead of O(n^3).
+// Throws std::runtime_error for a singular A.
+void bandedSolve(BandMatrix &matrix);
+
+// Solve a dense [A|B] whose A is banded: the band is detected (or taken from
+// `band`), the system is solved in band storage and X is written into the
+// right-hand-side columns; the A part is left untouched.
+void solveBanded(Matrix &matrix);
+void solveBanded(Matrix &matrix, Bandwidth band);
+
+#endif // SRC_BANDED_H
@@ -0,0 +1,193 @@
+#include "src_batched.h"
+#include "src_matrix_gen.h"
+#include "src_thread_pool.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+constexpr int L = MatrixBatch::kLanes;
+
+// One group of L systems; a(r, c) is the L-wide lane vector of element (r, c)
+struct GroupView {
+    double *base;
+    int cols;
+    double *a(int r, int c) const { return base + (static_cast<size_t>(r) * cols + c) * L; }
+};
+
+// Gauss-Jordan on L systems at once. Pivot choice, row swap and scaling are
+// per lane; the elimination sweep is a plain L-wide multiply-subtract.
+void eliminate_group(GroupView g, int n, uint8_t *singular) {
+    const int cols = g.cols;
+    bool dead[L] = {};
+
+    for (int k = 0; k < n; ++k) {
+        // per-lane partial pivoting on column k
+        int piv[L];
+        double maxv[L];
+        const double *akk = g.a(k, k);
+        for (int l = 0; l < L; ++l) {
+            piv[l] = k;
+            maxv[l] = std::fabs(akk[l]);
+        }
+        for (int i = k + 1; i < n; ++i) {
+            const double *aik = g.a(i, k);
+            for (int l = 0; l < L; ++l) {
+                double v = std::fabs(aik[l]);
+                bool better = v > maxv[l];
+                maxv[l] = better ? v : maxv[l];
+                piv[l] = better ? i : piv[l];
+            }
+        }
+
+        // swap rows k and piv[l] in the lanes that need it
+        for (int l = 0; l < L; ++l) {
+            if (maxv[l] < 1e-15) dead[l] = true;
+            if (piv[l] == k) continue;
+            double *rk = g.a(k, 0) + l;
+            double *rp = g.a(piv[l], 0) + l;
+            for (int c = 0; c < cols; ++c) std::swap(rk[c * L], rp[c * L]);
+        }
+
+        // scale pivot rows; a dead lane scales by 0 so it stays finite and inert
+        double inv[L];
+        for (int l = 0; l < L; ++l) inv[l] = dead[l] ? 0.0 : 1.0 / akk[l];
+        for (int c = 0; c < cols; ++c) {
+            double *akc = g.a(k, c);
+            for (int l = 0; l < L; ++l) akc[l] *= inv[l];
+        }
+
+        // eliminate column k from every other row, all lanes together
+        for (int i = 0; i < n; ++i) {
+            if (i == k) continue;
+            double f[L];
+            double *aik = g.a(i, k);
+            for (int l = 0; l < L; ++l) f[l] = aik[l];
+            for (int c = 0; c < cols; ++c) {
+                double *aic = g.a(i, c);
+                const double *akc = g.a(k, c);
+                for (int l = 0; l < L; ++l) aic[l] -= f[l] * akc[l];
+            }
+            for (int l = 0; l < L; ++l) aik[l] = 0.0;
+        }
+    }
+
+    for (int l = 0; l < L; ++l) singular[l] = dead[l] ? 1 : 0;
+}
+
+} // namespace
+
+MatrixBatch::MatrixBatch(int count, int n, int rhs)
+    : count(count), n(n), rhs(rhs), cols(n + rhs), groups((count + kLanes - 1) / kLanes) {
+    if (count < 0 || n < 0 || rhs < 0) throw std::invalid_argument("Invalid batch dimensions.");
+    allocate();
+    singular_.assign(static_cast<size_t>(groups) * kLanes, 0);
+    // padding lanes get A = I so they never look singular
+    for (int s = count; s < groups * kLanes; ++s)
+        for (int r = 0; r < n; ++r) at(s, r, r) = 1.0;
+}
+
+MatrixBatch::MatrixBatch(const MatrixBatch &other)
+    : count(other.count), n(other.n), rhs(other.rhs), cols(other.cols), groups(other.groups),
+      singular_(other.singular_) {
+    allocate();
+    if (data_) std::memcpy(data_, other.data_, elements() * sizeof(double));
+}
+
+MatrixBatch::MatrixBatch(MatrixBatch &&other) noexcept
+    : count(std::exchange(other.count, 0)), n(std::exchange(other.n, 0)), rhs(std::exchange(other.rhs, 0)),
+      cols(std::exchange(other.cols, 0)), groups(std::exchange(other.groups, 0)),
+      storage_(std::move(other.storage_)), data_(std::exchange(other.data_, nullptr)),
+      singular_(std::move(other.singular_)) {
+    other.singular_.clear();
+}
+
+MatrixBatch &MatrixBatch::operator=(MatrixBatch other) noexcept {
+    std::swap(count, other.count);
+    std::swap(n, other.n);
+    std::swap(rhs, other.rhs);
+    std::swap(cols, other.cols);
+    std::swap(groups, other.groups);
+    std::swap(storage_, other.storage_);
+    std::swap(data_, other.data_);
+    std::swap(singular_, other.singular_);
+    return *this;
+}
+
+// Zero-filled, Matrix::kAlignment-aligned storage for all groups
+void MatrixBatch::allocate() {
+    size_t bytes = elements() * sizeof(double);
+    if (bytes == 0) return;
+    void *p = std::aligned_alloc(Matrix::kAlignment, bytes);
+    if (!p) throw std::bad_alloc();
+    std::memset(p, 0, bytes);
+    storage_.reset(static_cast<double *>(p), [](double *q) { std::free(q); });
+    data_ = storage_.get();
+}
+
+void MatrixBatch::setSystem(int s, const Matrix &m) {
+    if (m.n != n || m.rhs != rhs) throw std::invalid_argument("System size does not match the batch.");
+    for (int r = 0; r < n; ++r) {
+        const double *src = m.row(r);
+        for (int c = 0; c < cols; ++c) at(s, r, c) = src[c];
+    }
+}
+
+Matrix MatrixBatch::system(int s) const {
+    Matrix m(n, rhs);
+    for (int r = 0; r < n; ++r) {
+        double *dst = m.row(r);
+        for (int c = 0; c < cols; ++c) dst[c] = at(s, r, c);
+    }
+    return m;
+}
+
+void MatrixBatch::fillRandom(uint64_t seed, double low, double high) {
+    MatrixGenOptions options;
+    options.low = low;
+    options.high = high;
+    std::vector<double> row(cols);
+    for (int s = 0; s < count; ++s) {
+        MatrixGenerator generator(n, rhs, seed + static_cast<uint64_t>(s), options);
+        for (int r = 0; r < n; ++r) {
+            generator.row(r, row.data());
+            for (int c = 0; c < cols; ++c) at(s, r, c) = row[c];
+        }
+    }
+}
+
+void gaussJordanBatched(MatrixBatch &batch, ThreadPool &pool) {
+    if (batch.count == 0 || batch.n == 0) return;
+    unsigned threadCount = pool.size();
+    pool.run([&batch, threadCount](unsigned tid) {
+        int begin, end;
+        splitRange(batch.groups, threadCount, tid, begin, end);
+        for (int g = begin; g < end; ++g) {
+            eliminate_group(GroupView{batch.group(g), batch.cols}, batch.n,
+                            batch.singular_.data() + static_cast<size_t>(g) * MatrixBatch::kLanes);
+        }
+    });
+}
+
+void gaussJordanBatched(MatrixBatch &batch, unsigned threadCount) {
+    if (threadCount == 0) {
+        unsigned hw = std::thread::hardware_concurrency();
+        threadCount = hw > 0 ? hw : 1;
+    }
+    // no point having more threads than lane groups
+    threadCount = std::min(threadCount, static_cast<unsigned>(std::max(1, batch.groups)));
+    gaussJordanBatched(batch, ThreadPool::shared(threadCount));
+}
+
+double maxResidualNorm(const MatrixBatch &orig, const MatrixBatch &reduced) {
+    double worst = 0.0;
+    for (int s = 0; s < orig.count; ++s) {
+        if (reduced.singular(s)) continue;
+        worst = std::max(worst, residualNorm(orig.system(s), reduced.system(s)));
+    }
+    return worst;
+}
@@ -0,0 +1,73 @@
+#ifndef SRC_BATCHED_H
+#define SRC_BATCHED_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "src_gauss_jordan.h"
+
+// A batch of many independent, same-size augmented systems [A|B] (n x (n+rhs))
+// stored for SIMD across systems. Systems are grouped kLanes at a time and the
+// element (r, c) of the systems in one group is kLanes consecutive doubles:
+//
+//   system s, element (r, c) -> data[((s / kLanes) * n * cols + r * cols + c) * kLanes + s % kLanes]
+//
+// so one vector register holds the same element of kLanes different systems.
+// Unused lanes of the last group hold an identity system and are never reported.
+class MatrixBatch {
+public:
+    static constexpr int kLanes = 8;
+
+    int count;  // number of systems
+    int n;      // rows of every system
+    int rhs;    // right-hand-side columns of every system
+    int cols;   // n + rhs
+    int groups; // ceil(count / kLanes)
+
+    MatrixBatch(int count, int n, int rhs = 1);
+    MatrixBatch(const MatrixBatch &other);
+    // Leaves `other` an empty batch (no systems, no storage)
+    MatrixBatch(MatrixBatch &&other) noexcept;
+    MatrixBatch &operator=(MatrixBatch other) noexcept;
+
+    double &at(int s, int r, int c) { return data_[index(s, r, c)]; }
+    double at(int s, int r, int c) const { return data_[index(s, r, c)]; }
+
+    // Start of group g (n * cols * kLanes doubles)
+    double *group(int g) { return data_ + static_cast<size_t>(g) * n * cols * kLanes; }
+
+    void setSystem(int s, const Matrix &m);
+    Matrix system(int s) const;
+
+    // Slot s gets the system of Matrix::fillRandom(low, high, seed + s)
+    void fillRandom(uint64_t seed, double low = -10.0, double high = 10.0);
+
+    // After a solve: true if system s hit a ~0 pivot (its solution is meaningless)
+    bool singular(int s) const { return singular_[s] != 0; }
+
+    friend void gaussJordanBatched(MatrixBatch &batch, ThreadPool &pool);
+
+private:
+    size_t index(int s, int r, int c) const {
+        return ((static_cast<size_t>(s / kLanes) * n + r) * cols + c) * kLanes + s % kLanes;
+    }
+
+    size_t elements() const { return static_cast<size_t>(groups) * n * cols * kLanes; }
+    void allocate();
+
+    std::shared_ptr<double> storage_;
+    double *data_ = nullptr;
+    std::vector<uint8_t> singular_;
+};
+
+// Gauss-Jordan with per-system partial pivoting on every system of the batch.
+// Groups of kLanes systems are eliminated together; groups are spread over
+// the pool's threads. A singular system is flagged instead of throwing, so one
+// bad input does not abort the rest of the batch.
+void gaussJordanBatched(MatrixBatch &batch, ThreadPool &pool);
+void gaussJordanBatched(MatrixBatch &batch, unsigned threadCount = 0);
+
+// Largest residualNorm over all non-singular systems of the batch
+double maxResidualNorm(const MatrixBatch &orig, const MatrixBatch &reduced);
+
+#endif // SRC_BATCHED_H
@@ -0,0 +1,136 @@
+#include "src_factor_cache.h"
+#include <algorithm>
+#include <cstring>
+
+static bool same_a(const std::vector<double> &a, const Matrix &matrix) {
+    int n = matrix.n;
+    if (a.size() != static_cast<size_t>(n) * n) return false;
+    for (int i = 0; i < n; ++i) {
+        if (std::memcmp(a.data() + static_cast<size_t>(i) * n, matrix.row(i), n * sizeof(double)) != 0)
+            return false;
+    }
+    return true;
+}
+
+FactorizationCache::FactorizationCache(size_t memoryBudgetBytes, int blockSize)
+    : budget_(memoryBudgetBytes), blockSize_(blockSize) {}
+
+uint64_t FactorizationCache::hashA(const Matrix &matrix) {
+    // Word-at-a-time multiply/xor-shift mix, seeded with the dimension
+    uint64_t h = 0x9E3779B97F4A7C15ull ^ static_cast<uint64_t>(matrix.n);
+    for (int i = 0; i < matrix.n; ++i) {
+        const double *r = matrix.row(i);
+        for (int j = 0; j < matrix.n; ++j) {
+            uint64_t w;
+            std::memcpy(&w, r + j, sizeof(w));
+            h = (h ^ w) * 0xFF51AFD7ED558CCDull;
+            h ^= h >> 32;
+        }
+    }
+    return h;
+}
+
+FactorizationCache::EntryPtr FactorizationCache::lookup(const Matrix &matrix, uint64_t hash) {
+    auto range = index_.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+        auto node = it->second;
+        if (!same_a((*node)->a, matrix)) continue;
+        lru_.splice(lru_.begin(), lru_, node); // mark as most recently used
+        return *node;
+    }
+    return nullptr;
+}
+
+void FactorizationCache::insert(const EntryPtr &entry) {
+    size_t need = entry->bytes();
+    if (need > budget_) return; // would never fit, solve uncached
+    // Another thread may have inserted the same A meanwhile
+    auto range = index_.equal_range(entry->hash);
+    for (auto it = range.first; it != range.second; ++it) {
+        if ((*it->second)->a == entry->a) return;
+    }
+    while (bytes_ + need > budget_ && !lru_.empty()) {
+        const EntryPtr &victim = lru_.back();
+        auto vr = index_.equal_range(victim->hash);
+        for (auto it = vr.first; it != vr.second; ++it) {
+            if (*it->second == victim) {
+                index_.erase(it);
+                break;
+            }
+        }
+        bytes_ -= victim->bytes();
+        lru_.pop_back();
+        ++evictions_;
+    }
+    lru_.push_front(entry);
+    index_.emplace(entry->hash, lru_.begin());
+    bytes_ += need;
+}
+
+void FactorizationCache::solve(Matrix &matrix) {
+    int n = matrix.n;
+    if (n == 0) return;
+
+    uint64_t hash = hashA(matrix);
+    EntryPtr entry;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        entry = lookup(matrix, hash);
+        if (entry) ++hits_;
+        else ++misses_;
+    }
+
+    if (!entry) {
+        // Factorize outside the lock; concurrent misses on other matrices proceed in parallel
+        auto fresh = std::make_shared<Entry>();
+        fresh->hash = hash;
+        fresh->a.resize(static_cast<size_t>(n) * n);
+        for (int i = 0; i < n; ++i) {
+            std::copy(matrix.row(i), matrix.row(i) + n, fresh->a.begin() + static_cast<size_t>(i) * n);
+        }
+        fresh->factors = luFactor<double>(matrix, blockSize_);
+        entry = fresh;
+        std::lock_guard<std::mutex> lock(mutex_);
+        insert(entry);
+    }
+
+    // O(n^2 * rhs) substitution on a copy of B, then write X back
+    std::vector<double> x = matrix.solutionBlock();
+    luSolveFactors(entry->factors, x.data(), matrix.rhs);
+    for (int i = 0; i < n; ++i) {
+        std::copy(x.begin() + static_cast<size_t>(i) * matrix.rhs,
+                  x.begin() + static_cast<size_t>(i + 1) * matrix.rhs, matrix.row(i) + n);
+    }
+}
+
+size_t FactorizationCache::hits() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hits_;
+}
+
+size_t FactorizationCache::misses() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return misses_;
+}
+
+size_t FactorizationCache::evictions() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return evictions_;
+}
+
+size_t FactorizationCache::entries() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return lru_.size();
+}
+
+size_t FactorizationCache::bytesUsed() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return bytes_;
+}
+
+void FactorizationCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    lru_.clear();
+    index_.clear();
+    bytes_ = 0;
+}
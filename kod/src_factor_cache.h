@@ -0,0 +1,64 @@
+#ifndef SRC_FACTOR_CACHE_H
+#define SRC_FACTOR_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "src_lu.h"
+
+// Solver for workloads that send the same coefficient matrix again and again
+// with different right-hand sides. The A part of each incoming Matrix is
+// hashed; on a hit the stored LU factors are reused and the solve costs only
+// the O(n^2 * rhs) forward/back substitution, on a miss A is factorized once
+// (O(n^3)) and the factors are kept in an LRU cache bounded by a memory budget.
+//
+// Every entry also keeps a copy of A, so a hash collision can never return
+// the wrong factors. solve() is safe to call from several threads.
+class FactorizationCache {
+public:
+    explicit FactorizationCache(size_t memoryBudgetBytes = size_t(256) << 20, int blockSize = 64);
+
+    // Solve [A|B] in place: the right-hand-side columns receive X, the A part
+    // is left as it was (unlike Gauss-Jordan, which reduces it to I).
+    // Throws std::runtime_error for a singular A.
+    void solve(Matrix &matrix);
+
+    size_t hits() const;
+    size_t misses() const;
+    size_t evictions() const;
+    size_t entries() const;
+    size_t bytesUsed() const;
+    size_t memoryBudget() const { return budget_; }
+    void clear();
+
+    // Content hash of the A part (logical row order, exact bit patterns)
+    static uint64_t hashA(const Matrix &matrix);
+
+private:
+    struct Entry {
+        uint64_t hash;
+        std::vector<double> a; // n x n copy of A, row-major
+        LUFactors<double> factors;
+        size_t bytes() const { return a.size() * sizeof(double) + factors.bytes(); }
+    };
+    using EntryPtr = std::shared_ptr<const Entry>;
+
+    EntryPtr lookup(const Matrix &matrix, uint64_t hash);
+    void insert(const EntryPtr &entry);
+
+    size_t budget_;
+    int blockSize_;
+    mutable std::mutex mutex_;
+    std::list<EntryPtr> lru_; // front = most recently used
+    std::unordered_multimap<uint64_t, std::list<EntryPtr>::iterator> index_;
+    size_t bytes_ = 0;
+    size_t hits_ = 0;
+    size_t misses_ = 0;
+    size_t evictions_ = 0;
+};
+
+#endif // SRC_FACTOR_CACHE_H
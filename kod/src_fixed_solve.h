@@ -0,0 +1,159 @@
+#ifndef SRC_FIXED_SOLVE_H
+#define SRC_FIXED_SOLVE_H
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "src_gauss_jordan.h"
+#include "src_matrix_gen.h"
+
+// Gauss-Jordan for systems whose size is known at compile time (n = 2..16 or
+// so): [A|B] lives in a std::array on the stack, and every loop of the
+// elimination is expanded by staticFor, so all indices are constants. The
+// compiler can then keep a small system in registers, and for small N the
+// pivot row exchange becomes a few selects instead of memory traffic.
+//
+// Header-only on purpose: each (N, RHS) is instantiated where it is used.
+
+// Largest N whose row exchange is expanded per candidate row; above it the
+// system no longer fits in registers and the expansion only costs code size
+constexpr int kFixedSelectSwapMax = 8;
+
+// N rows of N + RHS values. A struct rather than an alias of the nested
+// std::array, so that solve(m), residualNorm(a, b), ... deduce N and RHS.
+template <int N, int RHS = 1>
+struct FixedMatrix : std::array<std::array<double, N + RHS>, N> {};
+
+namespace fixed_detail {
+
+template <int Begin, typename F, int... I>
+inline void staticFor(F &&f, std::integer_sequence<int, I...>) {
+    (f(std::integral_constant<int, Begin + I>{}), ...);
+}
+
+} // namespace fixed_detail
+
+// f(std::integral_constant<int, i>) for i = Begin .. End-1, unrolled
+template <int Begin, int End, typename F>
+inline void staticFor(F &&f) {
+    if constexpr (End > Begin) {
+        fixed_detail::staticFor<Begin>(f, std::make_integer_sequence<int, End - Begin>{});
+    }
+}
+
+// Solve [A|B] in place: on return the A part is the identity and the RHS
+// columns hold X, as after gaussJordanSequential(). Same partial pivoting; the
+// pivot threshold stays the absolute 1e-15 (no pass over A to scale it).
+// Throws std::runtime_error for a singular A.
+template <int N, int RHS = 1>
+inline void solve(FixedMatrix<N, RHS> &m) {
+    constexpr int C = N + RHS;
+    staticFor<0, N>([&m](auto kc) {
+        constexpr int k = decltype(kc)::value;
+
+        int pivot_row = k;
+        double maxval = std::abs(m[k][k]);
+        staticFor<k + 1, N>([&](auto ic) {
+            constexpr int i = decltype(ic)::value;
+            double v = std::abs(m[i][k]);
+            if (v > maxval) {
+                maxval = v;
+                pivot_row = i;
+            }
+        });
+        if (maxval < 1e-15) {
+            throw std::runtime_error("Matrix is singular or nearly singular (pivot ~ 0).");
+        }
+        if constexpr (N <= kFixedSelectSwapMax) {
+            // Exchange with constant indices only (no run-time row addressing)
+            staticFor<k + 1, N>([&](auto ic) {
+                constexpr int i = decltype(ic)::value;
+                if (pivot_row == i) {
+                    staticFor<k, C>([&](auto jc) {
+                        constexpr int j = decltype(jc)::value;
+                        std::swap(m[k][j], m[i][j]);
+                    });
+                }
+            });
+        } else if (pivot_row != k) {
+            std::swap(m[k], m[pivot_row]);
+        }
+
+        double inv_pivot = 1.0 / m[k][k];
+        staticFor<k + 1, C>([&](auto jc) { m[k][decltype(jc)::value] *= inv_pivot; });
+        m[k][k] = 1.0;
+
+        staticFor<0, N>([&](auto ic) {
+            constexpr int i = decltype(ic)::value;
+            if constexpr (i != k) {
+                double factor = m[i][k];
+                staticFor<k + 1, C>([&](auto jc) {
+                    constexpr int j = decltype(jc)::value;
+                    m[i][j] -= factor * m[k][j];
+                });
+                m[i][k] = 0.0;
+            }
+        });
+    });
+}
+
+// Solution block X of a solved system
+template <int N, int RHS>
+inline std::array<std::array<double, RHS>, N> solution(const FixedMatrix<N, RHS> &m) {
+    std::array<std::array<double, RHS>, N> x;
+    for (int i = 0; i < N; ++i) {
+        for (int c = 0; c < RHS; ++c) x[i][c] = m[i][N + c];
+    }
+    return x;
+}
+
+// ||A*X - B||_F for the original system and a solved copy (as residualNorm)
+template <int N, int RHS>
+inline double residualNorm(const FixedMatrix<N, RHS> &orig, const FixedMatrix<N, RHS> &solved) {
+    double sumsq = 0.0;
+    for (int i = 0; i < N; ++i) {
+        for (int c = 0; c < RHS; ++c) {
+            double s = 0.0;
+            for (int j = 0; j < N; ++j) s += orig[i][j] * solved[j][N + c];
+            double r = s - orig[i][N + c];
+            sumsq += r * r;
+        }
+    }
+    return std::sqrt(sumsq);
+}
+
+// Same values as Matrix::fillRandom(low, high, seed) on an N x (N + RHS) system
+template <int N, int RHS>
+inline void fillRandom(FixedMatrix<N, RHS> &m, double low, double high, uint64_t seed) {
+    MatrixGenOptions options;
+    options.low = low;
+    options.high = high;
+    MatrixGenerator generator(N, RHS, seed, options);
+    for (int i = 0; i < N; ++i) generator.row(i, m[i].data());
+}
+
+// Conversions to and from the run-time sized Matrix, e.g. to check a fixed
+// solve against gaussJordanSequential() or residualNorm(Matrix, Matrix)
+template <int N, int RHS>
+inline Matrix toMatrix(const FixedMatrix<N, RHS> &m) {
+    Matrix out(N, RHS);
+    for (int i = 0; i < N; ++i) {
+        for (int j = 0; j < N + RHS; ++j) out.at(i, j) = m[i][j];
+    }
+    return out;
+}
+
+template <int N, int RHS>
+inline FixedMatrix<N, RHS> toFixed(const Matrix &m) {
+    if (m.n != N || m.rhs != RHS) throw std::invalid_argument("Matrix size does not match the fixed system.");
+    FixedMatrix<N, RHS> out;
+    for (int i = 0; i < N; ++i) {
+        for (int j = 0; j < N + RHS; ++j) out[i][j] = m.at(i, j);
+    }
+    return out;
+}
+
+#endif // SRC_FIXED_SOLVE_H
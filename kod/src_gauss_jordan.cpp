@@ -1,179 +1,511 @@
 #include "src_gauss_jordan.h"
+#include "src_matrix_gen.h"
+#include "src_thread_pool.h"
+#include "src_profile.h"
+#include <chrono>
 #include <random>
 #include <iomanip>
 #include <cmath>
 #include <thread>
 #include <algorithm>
 #include <stdexcept>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <atomic>
 
-Matrix::Matrix(int size) : n(size) {
-    data.assign(n, std::vector<double>(n + 1, 0.0));
+// Zero-filled buffer of rows * stride doubles aligned to Matrix::kAlignment
+static std::shared_ptr<double> allocate_rows(int rows, int stride) {
+    size_t bytes = static_cast<size_t>(rows) * stride * sizeof(double);
+    if (bytes == 0) return nullptr;
+    void *p = std::aligned_alloc(Matrix::kAlignment, bytes);
+    if (!p) throw std::bad_alloc();
+    std::memset(p, 0, bytes);
+    return std::shared_ptr<double>(static_cast<double *>(p), [](double *q) { std::free(q); });
+}
+
+static int padded_stride(int columns) {
+    return (columns + Matrix::kSimdWidth - 1) / Matrix::kSimdWidth * Matrix::kSimdWidth;
+}
+
+Matrix::Matrix(int size, int rhsCount)
+    : n(size), rhs(rhsCount), cols(size + rhsCount), stride(padded_stride(size + rhsCount)) {
+    if (rhsCount < 0) throw std::invalid_argument("Number of right-hand sides must be >= 0.");
+    buffer_ = allocate_rows(n, stride);
+    perm_.resize(n);
+    std::iota(perm_.begin(), perm_.end(), 0);
+}
+
+Matrix::Matrix(const Matrix &other)
+    : n(other.n), rhs(other.rhs), cols(other.cols), stride(other.stride), perm_(other.perm_) {
+    buffer_ = allocate_rows(n, stride);
+    if (buffer_) {
+        std::memcpy(buffer_.get(), other.buffer_.get(),
+                    static_cast<size_t>(n) * stride * sizeof(double));
+    }
+}
+
+Matrix::Matrix(Matrix &&other) noexcept
+    : n(other.n), rhs(other.rhs), cols(other.cols), stride(other.stride),
+      buffer_(std::move(other.buffer_)), perm_(std::move(other.perm_)) {
+    other.n = 0;
+    other.rhs = 1;
+    other.cols = 1;
+    other.stride = padded_stride(1);
+}
+
+Matrix &Matrix::operator=(Matrix other) noexcept {
+    std::swap(n, other.n);
+    std::swap(rhs, other.rhs);
+    std::swap(cols, other.cols);
+    std::swap(stride, other.stride);
+    std::swap(buffer_, other.buffer_);
+    std::swap(perm_, other.perm_);
+    return *this;
+}
+
+Matrix Matrix::fromBuffer(int size, int rhsCount, std::shared_ptr<double> buffer) {
+    Matrix m(0, rhsCount);
+    m.n = size;
+    m.cols = size + rhsCount;
+    m.stride = padded_stride(m.cols);
+    m.buffer_ = std::move(buffer);
+    m.perm_.resize(size);
+    std::iota(m.perm_.begin(), m.perm_.end(), 0);
+    return m;
 }
 
 void Matrix::print() const {
-    for (const auto &row : data) {
-        for (double val : row)
-            std::cout << std::setw(12) << std::setprecision(6) << val << " ";
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < cols; ++j)
+            std::cout << std::setw(12) << std::setprecision(6) << at(i, j) << " ";
         std::cout << "\n";
     }
     std::cout << std::endl;
 }
 
 void Matrix::fillRandom(double low, double high) {
-    std::mt19937_64 gen(std::random_device{}());
-    std::uniform_real_distribution<double> dist(low, high);
+    fillRandom(low, high, std::random_device{}());
+}
+
+void Matrix::fillRandom(double low, double high, uint64_t seed) {
+    // To reduce chance of singular matrix, enforce diagonal dominance:
+    // row_abs_sum + 1 is added to diagonal A[i][i]
+    MatrixGenOptions options;
+    options.low = low;
+    options.high = high;
+    fillSystem(*this, MatrixGenerator(n, rhs, seed, options));
+}
 
+Matrix Matrix::withIdentityRHS() const {
+    Matrix m(n, n);
     for (int i = 0; i < n; ++i) {
-        double row_abs_sum = 0.0;
-        for (int j = 0; j <= n; ++j) {
-            data[i][j] = dist(gen);
-            if (j < n) row_abs_sum += std::fabs(data[i][j]);
-        }
-        // To reduce chance of singular matrix, enforce diagonal dominance:
-        // add row_abs_sum + 1 to diagonal A[i][i]
-        data[i][i] += (row_abs_sum + 1.0);
+        const double *src = row(i);
+        double *dst = m.row(i);
+        std::copy(src, src + n, dst);
+        dst[n + i] = 1.0;
     }
+    return m;
 }
 
-// Helper: swap rows i and j
+std::vector<double> Matrix::solutionBlock() const {
+    std::vector<double> x(static_cast<size_t>(n) * rhs);
+    for (int i = 0; i < n; ++i) {
+        const double *r = row(i) + n;
+        std::copy(r, r + rhs, x.begin() + static_cast<size_t>(i) * rhs);
+    }
+    return x;
+}
+
+// Helper: swap rows i and j (permutation index only, no data moves)
 static void swap_rows(Matrix &m, int i, int j) {
-    std::swap(m.data[i], m.data[j]);
+    m.swapRows(i, j);
 }
 
 // Sequential Gauss-Jordan with partial pivoting
-void gaussJordanSequential(Matrix &matrix) {
+void gaussJordanSequential(Matrix &matrix, RowKernel kernel, SolveProfile *profile) {
     int n = matrix.n;
     if (n == 0) return;
 
+    RowUpdateFn update = rowUpdateKernel(kernel);
+    const size_t width = matrix.stride; // padding is zero, so sweep whole SIMD blocks
+    const double tiny = pivotThreshold(matrix);
+
+    auto started = profile ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+    ThreadRecorder rec(profile != nullptr);
+    rec.start();
+
     for (int k = 0; k < n; ++k) {
         // partial pivot: find max abs value in column k among rows k..n-1
         int pivot_row = k;
-        double maxval = std::abs(matrix.data[k][k]);
+        double maxval = std::abs(matrix.at(k, k));
         for (int i = k + 1; i < n; ++i) {
-            double v = std::abs(matrix.data[i][k]);
+            double v = std::abs(matrix.at(i, k));
             if (v > maxval) {
                 maxval = v;
                 pivot_row = i;
             }
         }
-        if (maxval < 1e-15) {
+        if (maxval <= tiny) {
             throw std::runtime_error("Matrix is singular or nearly singular (pivot ~ 0).");
         }
+        rec.mark(SolvePhase::PivotSearch);
         if (pivot_row != k) swap_rows(matrix, k, pivot_row);
+        rec.mark(SolvePhase::RowSwap);
 
         // scale pivot row so that pivot becomes 1
-        double pivot = matrix.data[k][k];
-        for (int j = 0; j <= n; ++j) matrix.data[k][j] /= pivot;
+        double *rk = matrix.row(k);
+        double pivot = rk[k];
+        for (int j = 0; j < matrix.cols; ++j) rk[j] /= pivot;
+        rec.mark(SolvePhase::PivotScale);
 
         // eliminate other rows
         for (int i = 0; i < n; ++i) {
             if (i == k) continue;
-            double factor = matrix.data[i][k];
+            double *ri = matrix.row(i);
+            double factor = ri[k];
             if (factor == 0.0) continue;
-            for (int j = 0; j <= n; ++j) {
-                matrix.data[i][j] -= factor * matrix.data[k][j];
-            }
+            update(ri, rk, width, factor);
             // numerically force zero
-            matrix.data[i][k] = 0.0;
+            ri[k] = 0.0;
         }
+        rec.mark(SolvePhase::Elimination);
+    }
+
+    if (profile) {
+        std::vector<ThreadProfile> threads(1);
+        rec.stop(&threads[0]);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+        finishProfile(profile, threads, ms);
     }
 }
 
-// Parallel Gauss-Jordan with std::thread
+// Parallel Gauss-Jordan on a persistent ThreadPool, lockstep schedule
 // Approach:
+//  - The whole solve is a single pool job; every thread owns a fixed block of rows.
 //  - For each pivot k:
-//      * do partial pivoting sequentially and swap rows if needed
-//      * scale pivot row sequentially (so pivot row is ready for use)
-//      * spawn threads, each thread processes a disjoint set of rows (excluding pivot row):
-//          for its rows i: factor = A[i][k]; A[i][j] -= factor * A[k][j] for j=0..n
-//      * join threads and move to next pivot
+//      * thread 0 does partial pivoting, swaps rows if needed and scales the pivot row
+//      * barrier (pivot row is ready for use)
+//      * every thread eliminates column k from its own rows (excluding the pivot row):
+//          for its rows i: factor = A[i][k]; A[i][j] -= factor * A[k][j] for every column j
+//      * barrier (column k is clean, next pivot search may start)
 //
-void gaussJordanParallel(Matrix &matrix, unsigned threadCount) {
-    int n = matrix.n;
-    if (n == 0) return;
+static void gaussJordanLockstep(Matrix &matrix, ThreadPool &pool, RowUpdateFn update,
+                                std::vector<ThreadProfile> *threadProfiles) {
+    const int n = matrix.n;
+    const size_t width = matrix.stride;
 
-    if (threadCount == 0) {
-        unsigned hw = std::thread::hardware_concurrency();
-        threadCount = hw > 0 ? hw : 1;
+    unsigned threadCount = pool.size();
+    SpinBarrier &barrier = pool.barrier();
+    bool singular = false; // written by thread 0 only, published by the barrier
+    const double tiny = pivotThreshold(matrix);
+
+    pool.run([&matrix, &barrier, &singular, n, threadCount, update, width, tiny, threadProfiles](unsigned tid) {
+        // We partition rows into roughly equal chunks, skipping the pivot row inside the loop
+        int start_row, end_row;
+        splitRange(n, threadCount, tid, start_row, end_row);
+        ThreadRecorder rec(threadProfiles != nullptr);
+        rec.start();
+
+        for (int k = 0; k < n; ++k) {
+            if (tid == 0) {
+                // partial pivoting (sequential)
+                int pivot_row = k;
+                double maxval = std::abs(matrix.at(k, k));
+                for (int i = k + 1; i < n; ++i) {
+                    double v = std::abs(matrix.at(i, k));
+                    if (v > maxval) {
+                        maxval = v;
+                        pivot_row = i;
+                    }
+                }
+                rec.mark(SolvePhase::PivotSearch);
+                if (maxval <= tiny) {
+                    singular = true;
+                } else {
+                    if (pivot_row != k) swap_rows(matrix, k, pivot_row);
+                    rec.mark(SolvePhase::RowSwap);
+
+                    // scale pivot row
+                    double *rk = matrix.row(k);
+                    double pivot = rk[k];
+                    for (int j = 0; j < matrix.cols; ++j) rk[j] /= pivot;
+                    rec.mark(SolvePhase::PivotScale);
+                }
+            }
+            barrier.arriveAndWait();
+            rec.mark(SolvePhase::Sync);
+            if (singular) return;
+
+            // Each thread modifies its own subset of physical rows [start_row, end_row).
+            // Swaps only touch the permutation, so a thread keeps the same memory
+            // for the whole solve and never has to know the logical row index.
+            int pivot_phys = matrix.physicalRow(k);
+            const double *rk = matrix.row(k);
+            for (int p = start_row; p < end_row; ++p) {
+                if (p == pivot_phys) continue; // pivot row skipped
+                double *ri = matrix.physicalRowData(p);
+                double factor = ri[k];
+                if (factor == 0.0) continue;
+                // update row i using pivot row k
+                update(ri, rk, width, factor);
+                // numerically force the column to zero
+                ri[k] = 0.0;
+            }
+            rec.mark(SolvePhase::Elimination);
+            barrier.arriveAndWait();
+            rec.mark(SolvePhase::Sync);
+        }
+        rec.stop(threadProfiles ? &(*threadProfiles)[tid] : nullptr);
+    });
+
+    if (singular) {
+        throw std::runtime_error("Matrix is singular or nearly singular (pivot ~ 0).");
     }
-    if (threadCount < 1) threadCount = 1;
+}
 
-    // limit threadCount to at most n (no point having more threads than rows)
-    if (threadCount > static_cast<unsigned>(n)) threadCount = static_cast<unsigned>(n);
+// Pipelined (lookahead) schedule of the parallel solve.
+// Approach:
+//  - Rows are owned as in the lockstep version, but step k is split per row into
+//      * the near part: column k+1, the only column the search for pivot k+1 reads
+//      * the far part: all other columns to the right of it
+//  - A thread applies the near part of step k to all its rows and announces it.
+//    Thread 0 searches pivot k+1 as soon as every thread has done so; the far
+//    parts of step k (and of up to `depth` older steps) are still in flight.
+//  - Scaled pivot rows are kept in a ring, so far updates can trail the pivot
+//    front. The multiplier of step s stays in column s of a row until the far
+//    part of step s has reached it; a near column first catches up on the steps
+//    still pending for its row.
+//  - Thread 0 locks the chosen pivot row and applies its pending far updates
+//    itself, so it never waits for the thread that owns it.
+//
+static void gaussJordanLookahead(Matrix &matrix, ThreadPool &pool, RowUpdateFn update, int depth,
+                                 std::vector<ThreadProfile> *threadProfiles) {
+    const int n = matrix.n;
+    const int width = matrix.stride;
+    const unsigned threadCount = pool.size();
+    depth = std::min(depth, n);
+    const int slots = depth + 2; // steps a far update may still need + the pivot being built
+    const double tiny = pivotThreshold(matrix);
 
-    for (int k = 0; k < n; ++k) {
-        // partial pivoting (sequential)
-        int pivot_row = k;
-        double maxval = std::abs(matrix.data[k][k]);
-        for (int i = k + 1; i < n; ++i) {
-            double v = std::abs(matrix.data[i][k]);
-            if (v > maxval) {
+    std::vector<double> pivotRing(static_cast<size_t>(slots) * width);
+    std::vector<int> pivotPhys(n, -1); // physical pivot row of each step
+    std::vector<char> used(n, 0);      // thread 0 only: rows that already were a pivot
+    std::unique_ptr<std::atomic<int>[]> farDone(new std::atomic<int>[n]); // last step fully applied to a row
+    std::unique_ptr<std::atomic<bool>[]> locked(new std::atomic<bool>[n]);
+    std::unique_ptr<std::atomic<unsigned>[]> nearDone(new std::atomic<unsigned>[n]); // threads past near part of a step
+    for (int i = 0; i < n; ++i) {
+        farDone[i].store(-1, std::memory_order_relaxed);
+        locked[i].store(false, std::memory_order_relaxed);
+        nearDone[i].store(0, std::memory_order_relaxed);
+    }
+    std::atomic<int> published{-1}; // last step whose pivot row is in the ring
+    std::atomic<bool> singular{false};
+
+    auto pivotRow = [&](int s) { return pivotRing.data() + static_cast<size_t>(s % slots) * width; };
+    auto lock = [&](int p) {
+        spinUntil([&] { return !locked[p].exchange(true, std::memory_order_acquire); });
+    };
+    auto unlock = [&](int p) { locked[p].store(false, std::memory_order_release); };
+
+    // Apply the far parts of the steps (farDone[p], upTo] to physical row p;
+    // columns left of `from` already went through them as near columns.
+    auto applyFar = [&](int p, int upTo, int from) {
+        double *r = matrix.physicalRowData(p);
+        for (int s = farDone[p].load(std::memory_order_relaxed) + 1; s <= upTo; ++s) {
+            if (pivotPhys[s] != p) {
+                double factor = r[s];
+                if (factor != 0.0 && from < width) update(r + from, pivotRow(s) + from, width - from, factor);
+                r[s] = 0.0;
+            }
+            farDone[p].store(s, std::memory_order_relaxed);
+        }
+    };
+
+    // Thread 0: choose, finish and scale the pivot row of step s. Column s of
+    // every row is up to date once all threads are past the near part of s-1.
+    auto producePivot = [&](int s, ThreadRecorder &rec) {
+        int best = -1;
+        double maxval = 0.0;
+        for (int p = 0; p < n; ++p) {
+            if (used[p]) continue;
+            double v = std::abs(matrix.physicalRowData(p)[s]);
+            if (best < 0 || v > maxval) {
                 maxval = v;
-                pivot_row = i;
+                best = p;
             }
         }
-        if (maxval < 1e-15) {
-            throw std::runtime_error("Matrix is singular or nearly singular (pivot ~ 0).");
+        if (maxval <= tiny) {
+            singular.store(true, std::memory_order_relaxed);
+            published.store(s, std::memory_order_release);
+            return;
         }
-        if (pivot_row != k) swap_rows(matrix, k, pivot_row);
+        rec.mark(SolvePhase::PivotSearch);
+        lock(best);
+        rec.mark(SolvePhase::Sync);
+        applyFar(best, s - 1, s + 1);
+        rec.mark(SolvePhase::Elimination);
+        double *r = matrix.physicalRowData(best);
+        double pivot = r[s];
+        for (int j = s; j < width; ++j) r[j] /= pivot;
+        std::copy(r, r + width, pivotRow(s));
+        farDone[best].store(s, std::memory_order_relaxed); // step s does not touch its own pivot row
+        unlock(best);
+        used[best] = 1;
+        pivotPhys[s] = best;
+        published.store(s, std::memory_order_release);
+        rec.mark(SolvePhase::PivotScale);
+    };
 
-        // scale pivot row
-        double pivot = matrix.data[k][k];
-        for (int j = 0; j <= n; ++j) matrix.data[k][j] /= pivot;
+    pool.run([&](unsigned tid) {
+        int begin, end;
+        splitRange(n, threadCount, tid, begin, end);
+        int t = -1; // last step whose near part this thread has applied
+        int cursor = begin;
+        ThreadRecorder rec(threadProfiles != nullptr);
+        rec.start();
 
-        // prepare worker function
-        auto worker = [&matrix, k, n](int start_row, int end_row) {
-            // Each thread modifies its own subset of rows [start_row, end_row)
-            for (int i = start_row; i < end_row; ++i) {
-                if (i == k) continue; // pivot row skipped
-                double factor = matrix.data[i][k];
-                if (factor == 0.0) continue;
-                // update row i using pivot row k
-                for (int j = 0; j <= n; ++j) {
-                    matrix.data[i][j] -= factor * matrix.data[k][j];
+        // One far update of an own row that trails step t; false if there is none
+        auto farWork = [&]() {
+            for (int i = begin; i < end; ++i) {
+                int p = cursor;
+                if (++cursor == end) cursor = begin;
+                if (farDone[p].load(std::memory_order_relaxed) >= t) continue;
+                if (locked[p].exchange(true, std::memory_order_acquire)) continue; // thread 0 has it
+                applyFar(p, t, t + 2);
+                unlock(p);
+                return true;
+            }
+            return false;
+        };
+        // Wait for ready(), doing far updates in the meantime
+        auto waitUntil = [&](auto ready) {
+            int idle = 0;
+            while (!ready()) {
+                if (farWork()) {
+                    idle = 0;
+                    rec.mark(SolvePhase::Elimination);
+                    continue;
                 }
-                // numerically force the column to zero
-                matrix.data[i][k] = 0.0;
+                if (++idle < 256) cpuRelax();
+                else std::this_thread::yield();
+                rec.mark(SolvePhase::Sync);
             }
         };
 
-        // spawn threads to work on rows [0..n)
-        std::vector<std::thread> threads;
-        threads.reserve(threadCount);
-
-        // We will partition rows into roughly equal chunks, but skipping pivot row inside worker
-        int rows = n;
-        int base_chunk = rows / static_cast<int>(threadCount);
-        int remainder = rows % static_cast<int>(threadCount);
-        int cur = 0;
-        for (unsigned t = 0; t < threadCount; ++t) {
-            int chunk = base_chunk + (t < static_cast<unsigned>(remainder) ? 1 : 0);
-            int start = cur;
-            int end = cur + chunk;
-            cur = end;
-            // If start==end we can skip creating a thread
-            if (start >= end) continue;
-            threads.emplace_back(worker, start, end);
+        if (tid == 0) producePivot(0, rec);
+        for (int s = 0; s < n; ++s) {
+            waitUntil([&] { return published.load(std::memory_order_acquire) >= s; });
+            if (singular.load(std::memory_order_relaxed)) return;
+
+            // Bound the lag of the far parts, so the ring slot of step s-depth-1 can be reused
+            for (int p = begin; p < end; ++p) {
+                if (farDone[p].load(std::memory_order_relaxed) >= s - depth) continue;
+                lock(p);
+                applyFar(p, s - depth, s + 1);
+                unlock(p);
+            }
+
+            // Near part of step s: column s+1, after the far steps still pending for the row
+            const int c = s + 1;
+            if (c < width) {
+                for (int p = begin; p < end; ++p) {
+                    if (p == pivotPhys[s]) continue;
+                    double *r = matrix.physicalRowData(p);
+                    double v = r[c];
+                    for (int q = farDone[p].load(std::memory_order_relaxed) + 1; q < s; ++q) {
+                        if (pivotPhys[q] != p) v -= r[q] * pivotRow(q)[c];
+                    }
+                    r[c] = v - r[s] * pivotRow(s)[c];
+                }
+            }
+            t = s;
+            nearDone[s].fetch_add(1, std::memory_order_release);
+            rec.mark(SolvePhase::Elimination);
+
+            if (tid == 0 && s + 1 < n) {
+                waitUntil([&] { return nearDone[s].load(std::memory_order_acquire) == threadCount; });
+                producePivot(s + 1, rec);
+            }
         }
 
-        // join threads
-        for (auto &th : threads) th.join();
+        for (int p = begin; p < end; ++p) {
+            lock(p);
+            applyFar(p, n - 1, n + 1);
+            unlock(p);
+        }
+        rec.mark(SolvePhase::Elimination);
+        rec.stop(threadProfiles ? &(*threadProfiles)[tid] : nullptr);
+    });
+
+    if (singular.load()) {
+        throw std::runtime_error("Matrix is singular or nearly singular (pivot ~ 0).");
+    }
+
+    // Logical row s is the pivot row of step s
+    std::vector<int> logical(n);
+    for (int r = 0; r < n; ++r) logical[matrix.physicalRow(r)] = r;
+    for (int s = 0; s < n; ++s) {
+        int j = logical[pivotPhys[s]];
+        if (j == s) continue;
+        matrix.swapRows(s, j);
+        logical[matrix.physicalRow(s)] = s;
+        logical[matrix.physicalRow(j)] = j;
     }
 }
 
-// residual: compute ||A*x - b||_2 where x is stored in last column of 'reduced' (after elimination).
-double residualNorm(const Matrix &orig, const Matrix &reduced) {
-    if (orig.n != reduced.n) return -1.0;
-    int n = orig.n;
-    std::vector<double> x(n);
-    for (int i = 0; i < n; ++i) x[i] = reduced.data[i][n]; // last column
+void gaussJordanParallel(Matrix &matrix, ThreadPool &pool, RowKernel kernel, int lookahead,
+                         SolveProfile *profile) {
+    int n = matrix.n;
+    if (n == 0) return;
 
-    double sumsq = 0.0;
-    for (int i = 0; i < n; ++i) {
-        double s = 0.0;
-        for (int j = 0; j < n; ++j) s += orig.data[i][j] * x[j];
-        double r = s - orig.data[i][n];
-        sumsq += r * r;
+    RowUpdateFn update = rowUpdateKernel(kernel);
+    auto started = profile ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+    std::vector<ThreadProfile> threadProfiles(profile ? pool.size() : 0);
+    std::vector<ThreadProfile> *profiles = profile ? &threadProfiles : nullptr;
+
+    if (lookahead > 0) {
+        gaussJordanLookahead(matrix, pool, update, lookahead, profiles);
+    } else {
+        gaussJordanLockstep(matrix, pool, update, profiles);
+    }
+
+    if (profile) {
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+        finishProfile(profile, threadProfiles, ms);
+    }
+}
+
+void gaussJordanParallel(Matrix &matrix, unsigned threadCount, RowKernel kernel, int lookahead,
+                         SolveProfile *profile) {
+    int n = matrix.n;
+    if (n == 0) return;
+
+    if (threadCount == 0) {
+        unsigned hw = std::thread::hardware_concurrency();
+        threadCount = hw > 0 ? hw : 1;
     }
-    return std::sqrt(sumsq);
+    if (threadCount < 1) threadCount = 1;
+
+    // limit threadCount to at most n (no point having more threads than rows)
+    if (threadCount > static_cast<unsigned>(n)) threadCount = static_cast<unsigned>(n);
+
+    // Workers are started once per process and parked between solves
+    gaussJordanParallel(matrix, ThreadPool::shared(threadCount), kernel, lookahead, profile);
+}
+
+double pivotThreshold(const Matrix &matrix) {
+    double scale = 0.0;
+    for (int i = 0; i < matrix.n; ++i) {
+        const double *a = matrix.row(i);
+        for (int j = 0; j < matrix.n; ++j) scale = std::max(scale, std::abs(a[j]));
+    }
+    return std::numeric_limits<double>::epsilon() * scale;
+}
+
+std::vector<double> inverse(const Matrix &a, RowKernel kernel) {
+    Matrix work = a.withIdentityRHS();
+    gaussJordanSequential(work, kernel);
+    return work.solutionBlock();
 }
@@ -1,28 +1,127 @@
 #ifndef SRC_GAUSS_JORDAN_H
 #define SRC_GAUSS_JORDAN_H
 
+#include <cstdint>
 #include <vector>
 #include <iostream>
+#include <memory>
+#include <utility>
+#include "src_row_kernels.h"
+#include "src_profile.h"
 
-// Matrix stores an augmented matrix of size n x (n+1) representing [A|b]
+// Matrix stores an augmented matrix of size n x (n+rhs) representing [A|B]:
+// the usual single right-hand side b (rhs = 1), several of them solved in one
+// pass, or B = I (rhs = n) to get the inverse of A out of the same elimination.
+//
+// Storage is one contiguous buffer: every row starts on a 64-byte boundary and
+// the row stride is padded to a whole number of SIMD registers (8 doubles).
+// Padding is zero, so kernels may sweep a full stride without a scalar tail.
+// Row swaps only exchange entries of a row-permutation index; row r of the
+// logical matrix lives in physical row perm[r] of the buffer.
 class Matrix {
 public:
-    int n;
-    std::vector<std::vector<double>> data; // n rows, n+1 columns
+    static constexpr int kAlignment = 64;                        // bytes
+    static constexpr int kSimdWidth = kAlignment / sizeof(double); // doubles
+
+    int n;      // number of rows (and of columns of A)
+    int rhs;    // number of right-hand-side columns
+    int cols;   // n + rhs
+    int stride; // distance between rows in doubles, multiple of kSimdWidth
+
+    Matrix(int size = 0, int rhsCount = 1);
+    Matrix(const Matrix &other);
+    Matrix(Matrix &&other) noexcept;
+    Matrix &operator=(Matrix other) noexcept;
+
+    // Adopt storage that already has the layout described above (rows of
+    // `stride` doubles, 64-byte aligned, zero padding), e.g. a mapped file.
+    // The shared_ptr's deleter releases it; no data is copied.
+    static Matrix fromBuffer(int size, int rhsCount, std::shared_ptr<double> buffer);
 
-    Matrix(int size = 0);
     void print() const;
     void fillRandom(double low = -10.0, double high = 10.0);
+    // Reproducible variant: the same seed always gives the same matrix, filled
+    // in parallel for large n (a diagonally dominant MatrixGenerator system,
+    // see src_matrix_gen.h)
+    void fillRandom(double low, double high, uint64_t seed);
+
+    // Copy of this matrix's A part augmented with the identity: [A | I]
+    Matrix withIdentityRHS() const;
+
+    // Solution block X (n x rhs, row-major) once the system has been solved
+    std::vector<double> solutionBlock() const;
+
+    // Element (r, c) of the logical (permuted) matrix
+    double &at(int r, int c) { return buffer_.get()[static_cast<size_t>(perm_[r]) * stride + c]; }
+    const double &at(int r, int c) const { return buffer_.get()[static_cast<size_t>(perm_[r]) * stride + c]; }
+
+    // Start of logical row r (aligned to kAlignment)
+    double *row(int r) { return buffer_.get() + static_cast<size_t>(perm_[r]) * stride; }
+    const double *row(int r) const { return buffer_.get() + static_cast<size_t>(perm_[r]) * stride; }
+
+    // O(1) row exchange through the permutation index
+    void swapRows(int i, int j) { std::swap(perm_[i], perm_[j]); }
+
+    // Physical buffer row that currently holds logical row r
+    int physicalRow(int r) const { return perm_[r]; }
+
+    // Start of physical buffer row p, independent of the permutation
+    double *physicalRowData(int p) { return buffer_.get() + static_cast<size_t>(p) * stride; }
+    const double *physicalRowData(int p) const { return buffer_.get() + static_cast<size_t>(p) * stride; }
+
+private:
+    std::shared_ptr<double> buffer_;
+    std::vector<int> perm_;
 };
 
 // Sequential Gauss-Jordan (existing single-threaded algorithm)
-void gaussJordanSequential(Matrix &matrix);
+// `kernel` selects the implementation of the row update (see src_row_kernels.h).
+// A non-null `profile` receives phase timings (see src_profile.h).
+void gaussJordanSequential(Matrix &matrix, RowKernel kernel = RowKernel::Cpp, SolveProfile *profile = nullptr);
+
+class ThreadPool;
 
 // Parallel Gauss-Jordan: threadCount = number of worker threads to use (>=1)
-// The function assumes matrix is a valid augmented matrix n x (n+1).
-void gaussJordanParallel(Matrix &matrix, unsigned threadCount = 0);
+// The function assumes matrix is a valid augmented matrix n x (n+rhs).
+// Runs on a process-wide pool that is created on first use and then reused.
+//
+// lookahead = 0 runs the lockstep schedule (two pool barriers per pivot).
+// lookahead = d > 0 pipelines the steps: only column k+1 is updated before the
+// search for pivot k+1 starts, the rest of every row may trail the pivot
+// front by up to d steps, and threads never meet at a full barrier.
+void gaussJordanParallel(Matrix &matrix, unsigned threadCount = 0,
+                         RowKernel kernel = RowKernel::Cpp, int lookahead = 0,
+                         SolveProfile *profile = nullptr);
+
+// Same as above on a caller-owned pool (one thread per pool slot).
+void gaussJordanParallel(Matrix &matrix, ThreadPool &pool, RowKernel kernel = RowKernel::Cpp,
+                         int lookahead = 0, SolveProfile *profile = nullptr);
+
+// How the residual adds up the products of a row
+enum class Summation {
+    Plain,       // vectorized dot products
+    Compensated, // Dot2 (Ogita, Rump, Oishi): as if in twice the working precision, ~4x the flops
+};
+
+// Compute residual norm ||Ax - b||_2 for the original A and solution in the last column.
+// With several right-hand sides this is the Frobenius norm ||AX - B||_F over all of them.
+double residualNorm(const Matrix &orig, const Matrix &reduced, Summation summation = Summation::Plain);
+
+// R = B - A*X for the original system `orig` and a solution block X (n x rhs,
+// row-major, as from solutionBlock()); R gets the same shape. Returns ||R||_F.
+// Large systems are split by rows over the shared pool of `threadCount`
+// threads (0 = hardware concurrency); must not be called from a job of that pool.
+double residualBlock(const Matrix &orig, const std::vector<double> &x, std::vector<double> &r,
+                     Summation summation = Summation::Plain, unsigned threadCount = 0);
+
+// Pivots with |pivot| <= pivotThreshold(A) count as zero: machine epsilon
+// times the largest |a_ij| of the A part, i.e. the pivot is lost in the
+// rounding of the matrix's own entries. Relative, so scaling A does not change
+// which systems are rejected; how accurate an accepted solve is, is for the
+// condition estimate to say (see luConditionEstimate in src_lu.h).
+double pivotThreshold(const Matrix &matrix);
 
-// Compute residual norm ||Ax - b||_2 for the original A and solution in the last column
-double residualNorm(const Matrix &orig, const Matrix &reduced);
+// Inverse of the A part of `a` (n x n, row-major) by Gauss-Jordan on [A | I]
+std::vector<double> inverse(const Matrix &a, RowKernel kernel = RowKernel::Cpp);
 
 #endif // SRC_GAUSS_JORDAN_H
@@ -1,19 +1,145 @@
-.global gaussJordanASM
-.extern printf
+# Row-update kernels for Gauss-Jordan elimination (x86-64, System V ABI, GNU as)
+#
+#   void gj_row_update_<isa>(double *dst, const double *src, size_t count, double factor)
+#
+#   dst[j] -= factor * src[j]   for j = 0 .. count-1
+#
+#   rdi = dst, rsi = src, rdx = count, xmm0 = factor
+#
+# Loads and stores are unaligned-tolerant; Matrix rows are 64-byte aligned and
+# padded to a multiple of 8 doubles, so the scalar/masked tails normally do not run.
+# The AVX2 and AVX-512 variants use fused multiply-add (one rounding per element).
 
-gaussJordanASM:
-    // Save link register & frame pointer
-    stp x29, x30, [sp, #-16]!
-    mov x29, sp
+    .text
 
-    // Load address of message into x0
-    adrp x0, msg@PAGE
-    add  x0, x0, msg@PAGEOFF
-    bl   _printf      // call printf
+# ---------------------------------------------------------------- SSE2
+    .globl  gj_row_update_sse2
+    .type   gj_row_update_sse2, @function
+    .p2align 4
+gj_row_update_sse2:
+    unpcklpd %xmm0, %xmm0           # factor in both lanes
+    movq    %rdx, %rcx
+    shrq    $2, %rcx                # 4 doubles per iteration
+    jz      .Lsse2_tail
+.Lsse2_loop:
+    movupd  (%rsi), %xmm1
+    movupd  16(%rsi), %xmm2
+    mulpd   %xmm0, %xmm1
+    mulpd   %xmm0, %xmm2
+    movupd  (%rdi), %xmm3
+    movupd  16(%rdi), %xmm4
+    subpd   %xmm1, %xmm3
+    subpd   %xmm2, %xmm4
+    movupd  %xmm3, (%rdi)
+    movupd  %xmm4, 16(%rdi)
+    addq    $32, %rsi
+    addq    $32, %rdi
+    decq    %rcx
+    jnz     .Lsse2_loop
+.Lsse2_tail:
+    andq    $3, %rdx
+    jz      .Lsse2_done
+.Lsse2_tail_loop:
+    movsd   (%rsi), %xmm1
+    mulsd   %xmm0, %xmm1
+    movsd   (%rdi), %xmm3
+    subsd   %xmm1, %xmm3
+    movsd   %xmm3, (%rdi)
+    addq    $8, %rsi
+    addq    $8, %rdi
+    decq    %rdx
+    jnz     .Lsse2_tail_loop
+.Lsse2_done:
+    ret
+    .size   gj_row_update_sse2, .-gj_row_update_sse2
+
+# ---------------------------------------------------------------- AVX2 + FMA
+    .globl  gj_row_update_avx2
+    .type   gj_row_update_avx2, @function
+    .p2align 4
+gj_row_update_avx2:
+    vbroadcastsd %xmm0, %ymm0
+    movq    %rdx, %rcx
+    shrq    $3, %rcx                # 8 doubles per iteration
+    jz      .Lavx2_tail
+.Lavx2_loop:
+    vmovupd (%rsi), %ymm1
+    vmovupd 32(%rsi), %ymm2
+    vmovupd (%rdi), %ymm3
+    vmovupd 32(%rdi), %ymm4
+    vfnmadd231pd %ymm1, %ymm0, %ymm3    # ymm3 -= factor * src
+    vfnmadd231pd %ymm2, %ymm0, %ymm4
+    vmovupd %ymm3, (%rdi)
+    vmovupd %ymm4, 32(%rdi)
+    addq    $64, %rsi
+    addq    $64, %rdi
+    decq    %rcx
+    jnz     .Lavx2_loop
+.Lavx2_tail:
+    andq    $7, %rdx
+    jz      .Lavx2_done
+.Lavx2_tail_loop:
+    vmovsd  (%rsi), %xmm1
+    vmovsd  (%rdi), %xmm3
+    vfnmadd231sd %xmm1, %xmm0, %xmm3
+    vmovsd  %xmm3, (%rdi)
+    addq    $8, %rsi
+    addq    $8, %rdi
+    decq    %rdx
+    jnz     .Lavx2_tail_loop
+.Lavx2_done:
+    vzeroupper
+    ret
+    .size   gj_row_update_avx2, .-gj_row_update_avx2
 
-    // Restore stack & return
-    ldp x29, x30, [sp], #16
+# ---------------------------------------------------------------- AVX-512F
+    .globl  gj_row_update_avx512
+    .type   gj_row_update_avx512, @function
+    .p2align 4
+gj_row_update_avx512:
+    vbroadcastsd %xmm0, %zmm0
+    movq    %rdx, %rcx
+    shrq    $4, %rcx                # 16 doubles per iteration
+    jz      .Lavx512_rest
+.Lavx512_loop:
+    vmovupd (%rsi), %zmm1
+    vmovupd 64(%rsi), %zmm2
+    vmovupd (%rdi), %zmm3
+    vmovupd 64(%rdi), %zmm4
+    vfnmadd231pd %zmm1, %zmm0, %zmm3
+    vfnmadd231pd %zmm2, %zmm0, %zmm4
+    vmovupd %zmm3, (%rdi)
+    vmovupd %zmm4, 64(%rdi)
+    addq    $128, %rsi
+    addq    $128, %rdi
+    decq    %rcx
+    jnz     .Lavx512_loop
+.Lavx512_rest:
+    andq    $15, %rdx
+    jz      .Lavx512_done
+    cmpq    $8, %rdx
+    jb      .Lavx512_masked
+    vmovupd (%rsi), %zmm1           # one full register of the remainder
+    vmovupd (%rdi), %zmm3
+    vfnmadd231pd %zmm1, %zmm0, %zmm3
+    vmovupd %zmm3, (%rdi)
+    addq    $64, %rsi
+    addq    $64, %rdi
+    subq    $8, %rdx
+    jz      .Lavx512_done
+.Lavx512_masked:
+    movl    %edx, %ecx              # 1..7 doubles left: k1 = (1 << rdx) - 1
+    movl    $1, %eax
+    shll    %cl, %eax
+    decl    %eax
+    kmovw   %eax, %k1
+    vmovupd (%rsi), %zmm1{%k1}{z}
+    vmovupd (%rdi), %zmm3{%k1}{z}
+    vfnmadd231pd %zmm1, %zmm0, %zmm3
+    vmovupd %zmm3, (%rdi){%k1}
+.Lavx512_done:
+    vzeroupper
     ret
+    .size   gj_row_update_avx512, .-gj_row_update_avx512
 
-msg:
-    .asciz "Hello from Assembly!\n"
+    .section .note.GNU-stack,"",@progbits
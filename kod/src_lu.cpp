@@ -0,0 +1,399 @@
+#include "src_lu.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+
+// Register block of the trailing update: MR rows x NR columns of C stay in
+// registers while the loop over the panel depth runs.
+constexpr int MR = 4;
+constexpr int NR = 8;
+// Columns of U12 processed per sweep (keeps the U12 strip resident in L2)
+constexpr int KC_COLUMNS = 512;
+
+// Unblocked factorization of the panel columns [k0, k1) over rows [k0, n).
+// Row swaps exchange whole rows, so they also apply to L, the trailing part
+// and the right-hand sides.
+template <typename T>
+void factor_panel(std::vector<T *> &rows, int n, int k0, int k1, std::vector<int> &pivots, T tiny) {
+    for (int k = k0; k < k1; ++k) {
+        int pivot_row = k;
+        T maxval = std::abs(rows[k][k]);
+        for (int i = k + 1; i < n; ++i) {
+            T v = std::abs(rows[i][k]);
+            if (v > maxval) {
+                maxval = v;
+                pivot_row = i;
+            }
+        }
+        if (maxval <= tiny) {
+            throw std::runtime_error("Matrix is singular or nearly singular (pivot ~ 0).");
+        }
+        pivots[k] = pivot_row;
+        if (pivot_row != k) std::swap(rows[k], rows[pivot_row]);
+
+        const T *rk = rows[k];
+        T inv_pivot = T(1) / rk[k];
+        for (int i = k + 1; i < n; ++i) {
+            T *ri = rows[i];
+            T l = ri[k] * inv_pivot;
+            ri[k] = l;
+            if (l == T(0)) continue;
+            for (int j = k + 1; j < k1; ++j) ri[j] -= l * rk[j];
+        }
+    }
+}
+
+// U12 = L11^-1 * A12 for the block rows [k0, k1) and columns [k1, width)
+template <typename T>
+void solve_block_row(std::vector<T *> &rows, int k0, int k1, int width) {
+    for (int i = k0 + 1; i < k1; ++i) {
+        T *ri = rows[i];
+        for (int p = k0; p < i; ++p) {
+            T l = ri[p];
+            if (l == T(0)) continue;
+            const T *rp = rows[p];
+            for (int j = k1; j < width; ++j) ri[j] -= l * rp[j];
+        }
+    }
+}
+
+// C[i][j..j+NR) -= sum_p L[i][p] * U[p][j..j+NR) for MR rows starting at i
+template <typename T>
+inline void gemm_micro(std::vector<T *> &rows, int i, int j, int k0, int k1) {
+#if defined(__GNUC__)
+    // One accumulator vector per row. GCC does not vectorize the plain loop
+    // below for float, which would throw away the point of float factors.
+    typedef T Lanes __attribute__((vector_size(NR * sizeof(T))));
+    Lanes acc[MR] = {};
+    const T *a0 = rows[i], *a1 = rows[i + 1], *a2 = rows[i + 2], *a3 = rows[i + 3];
+    for (int p = k0; p < k1; ++p) {
+        Lanes u;
+        std::memcpy(&u, rows[p] + j, sizeof(Lanes));
+        acc[0] += a0[p] * u;
+        acc[1] += a1[p] * u;
+        acc[2] += a2[p] * u;
+        acc[3] += a3[p] * u;
+    }
+    for (int r = 0; r < MR; ++r) {
+        Lanes c;
+        T *ci = rows[i + r] + j;
+        std::memcpy(&c, ci, sizeof(Lanes));
+        c -= acc[r];
+        std::memcpy(ci, &c, sizeof(Lanes));
+    }
+#else
+    T acc[MR][NR] = {};
+    const T *a0 = rows[i] + k0;
+    const T *a1 = rows[i + 1] + k0;
+    const T *a2 = rows[i + 2] + k0;
+    const T *a3 = rows[i + 3] + k0;
+    for (int p = k0; p < k1; ++p) {
+        const T *u = rows[p] + j;
+        T l0 = a0[p - k0], l1 = a1[p - k0], l2 = a2[p - k0], l3 = a3[p - k0];
+        for (int c = 0; c < NR; ++c) {
+            acc[0][c] += l0 * u[c];
+            acc[1][c] += l1 * u[c];
+            acc[2][c] += l2 * u[c];
+            acc[3][c] += l3 * u[c];
+        }
+    }
+    for (int r = 0; r < MR; ++r) {
+        T *ci = rows[i + r] + j;
+        for (int c = 0; c < NR; ++c) ci[c] -= acc[r][c];
+    }
+#endif
+}
+
+// Single-row / narrow-column fallback for the edges of the trailing matrix
+template <typename T>
+inline void gemm_edge(std::vector<T *> &rows, int i, int j0, int j1, int k0, int k1) {
+    T *ci = rows[i];
+    for (int p = k0; p < k1; ++p) {
+        T l = ci[p];
+        if (l == T(0)) continue;
+        const T *u = rows[p];
+        for (int j = j0; j < j1; ++j) ci[j] -= l * u[j];
+    }
+}
+
+// A22 -= L21 * U12 for rows [k1, n) and columns [k1, width)
+template <typename T>
+void update_trailing(std::vector<T *> &rows, int n, int k0, int k1, int width) {
+    luUpdateTile(rows, k1, n, k1, width, k0, k1);
+}
+
+// In-place solves with the factors of a row-pointer view: x <- (L*U)^-1 x and
+// x <- (L*U)^-T x. The row permutation does not change a 1-norm, so the
+// estimator below works on L*U alone.
+template <typename Row>
+void lu_solve_vector(Row row, int n, std::vector<double> &x) {
+    for (int i = 0; i < n; ++i) {
+        const auto *li = row(i);
+        double s = x[i];
+        for (int j = 0; j < i; ++j) s -= li[j] * x[j];
+        x[i] = s;
+    }
+    for (int i = n - 1; i >= 0; --i) {
+        const auto *ui = row(i);
+        double s = x[i];
+        for (int j = i + 1; j < n; ++j) s -= ui[j] * x[j];
+        x[i] = s / ui[i];
+    }
+}
+
+template <typename Row>
+void lu_solve_vector_transposed(Row row, int n, std::vector<double> &x) {
+    // U^T z = x: column i of U is row i, so scatter finished entries forward
+    for (int i = 0; i < n; ++i) {
+        const auto *ui = row(i);
+        x[i] /= ui[i];
+        for (int j = i + 1; j < n; ++j) x[j] -= ui[j] * x[i];
+    }
+    // L^T x = z, scattered backward
+    for (int i = n - 1; i >= 0; --i) {
+        const auto *li = row(i);
+        for (int j = 0; j < i; ++j) x[j] -= li[j] * x[i];
+    }
+}
+
+double sum_abs(const std::vector<double> &x) {
+    double s = 0.0;
+    for (double v : x) s += std::abs(v);
+    return s;
+}
+
+// ||(L*U)^-1||_1 by Hager/Higham (the iteration of LAPACK dlacn2): a gradient
+// ascent of ||B x||_1 over the unit ball, started from the uniform vector and
+// ending at a vertex e_j, plus Higham's alternating vector against matrices
+// that fool the ascent.
+template <typename Row>
+double inverse_norm1_estimate(Row row, int n) {
+    constexpr int kMaxIterations = 5;
+    if (n == 0) return 0.0;
+
+    std::vector<double> x(n, 1.0 / n);
+    lu_solve_vector(row, n, x);
+    if (n == 1) return std::abs(x[0]);
+    double estimate = sum_abs(x);
+
+    auto sign = [](double v) { return v >= 0.0 ? 1.0 : -1.0; };
+    auto argmax_abs = [](const std::vector<double> &z) {
+        return static_cast<int>(std::max_element(z.begin(), z.end(), [](double a, double b) {
+            return std::abs(a) < std::abs(b);
+        }) - z.begin());
+    };
+
+    std::vector<double> xi(n), z(n);
+    for (int i = 0; i < n; ++i) xi[i] = sign(x[i]);
+    z = xi;
+    lu_solve_vector_transposed(row, n, z);
+    int j = argmax_abs(z);
+
+    for (int iteration = 2; iteration <= kMaxIterations; ++iteration) {
+        std::fill(x.begin(), x.end(), 0.0);
+        x[j] = 1.0;
+        lu_solve_vector(row, n, x);
+        double previous = estimate;
+        estimate = sum_abs(x);
+
+        bool same_signs = true;
+        for (int i = 0; i < n && same_signs; ++i) same_signs = sign(x[i]) == xi[i];
+        if (same_signs || estimate <= previous) {
+            estimate = std::max(estimate, previous);
+            break;
+        }
+        for (int i = 0; i < n; ++i) xi[i] = sign(x[i]);
+        z = xi;
+        lu_solve_vector_transposed(row, n, z);
+        int last = j;
+        j = argmax_abs(z);
+        if (std::abs(z[last]) == std::abs(z[j])) break;
+    }
+
+    for (int i = 0; i < n; ++i) x[i] = (i % 2 ? -1.0 : 1.0) * (1.0 + double(i) / (n - 1));
+    lu_solve_vector(row, n, x);
+    return std::max(estimate, 2.0 * sum_abs(x) / (3.0 * n));
+}
+
+} // namespace
+
+template <typename T>
+void luUpdateTile(std::vector<T *> &rows, int i0, int i1, int j0, int j1, int k0, int k1) {
+    for (int jc = j0; jc < j1; jc += KC_COLUMNS) {
+        int jend = std::min(jc + KC_COLUMNS, j1);
+        int jvec = jc + (jend - jc) / NR * NR;
+        int i = i0;
+        for (; i + MR <= i1; i += MR) {
+            for (int j = jc; j < jvec; j += NR) gemm_micro(rows, i, j, k0, k1);
+            if (jvec < jend) {
+                for (int r = 0; r < MR; ++r) gemm_edge(rows, i + r, jvec, jend, k0, k1);
+            }
+        }
+        for (; i < i1; ++i) gemm_edge(rows, i, jc, jend, k0, k1);
+    }
+}
+
+template <typename T>
+void luFactorRows(std::vector<T *> &rows, int n, int width, int blockSize, std::vector<int> &pivots) {
+    pivots.assign(n, 0);
+    if (n == 0) return;
+    // Keep block boundaries on NR columns so the micro-kernel never straddles them
+    int nb = std::max(NR, blockSize / NR * NR);
+
+    // Relative pivot threshold, as pivotThreshold() but in the working precision T
+    T scale = T(0);
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < n; ++j) scale = std::max(scale, std::abs(rows[i][j]));
+    }
+    const T tiny = std::numeric_limits<T>::epsilon() * scale;
+
+    for (int k0 = 0; k0 < n; k0 += nb) {
+        int k1 = std::min(k0 + nb, n);
+        factor_panel(rows, n, k0, k1, pivots, tiny);
+        solve_block_row(rows, k0, k1, width);
+        update_trailing(rows, n, k0, k1, width);
+    }
+}
+
+// Row-oriented: X_i = (Y_i - sum_{j>i} U_ij * X_j) / U_ii, where every X_j is
+// a contiguous strip of `count` values at the end of an already finished row.
+template <typename T>
+void luBackSubstitute(const std::vector<T *> &rows, int n, int column, int count) {
+    for (int i = n - 1; i >= 0; --i) {
+        T *ri = rows[i];
+        T *xi = ri + column;
+        if (count == 1) {
+            T s = xi[0];
+            for (int j = i + 1; j < n; ++j) s -= ri[j] * rows[j][column];
+            xi[0] = s;
+        } else {
+            for (int j = i + 1; j < n; ++j) {
+                T u = ri[j];
+                if (u == T(0)) continue;
+                const T *xj = rows[j] + column;
+                for (int c = 0; c < count; ++c) xi[c] -= u * xj[c];
+            }
+        }
+        T inv = T(1) / ri[i];
+        for (int c = 0; c < count; ++c) xi[c] *= inv;
+    }
+}
+
+template <typename T>
+LUFactors<T> luFactor(const Matrix &matrix, int blockSize) {
+    LUFactors<T> f;
+    int n = matrix.n;
+    f.n = n;
+    f.stride = (n + NR - 1) / NR * NR;
+    f.lu.assign(static_cast<size_t>(n) * f.stride, T(0));
+
+    std::vector<T *> rows(n);
+    for (int i = 0; i < n; ++i) {
+        const double *src = matrix.row(i);
+        T *dst = f.lu.data() + static_cast<size_t>(i) * f.stride;
+        for (int j = 0; j < n; ++j) dst[j] = static_cast<T>(src[j]);
+        rows[i] = dst;
+    }
+    luFactorRows(rows, n, f.stride, blockSize, f.pivots);
+
+    // Store the rows in their final (pivoted) order
+    std::vector<T> ordered(f.lu.size());
+    for (int i = 0; i < n; ++i) {
+        std::copy(rows[i], rows[i] + f.stride, ordered.begin() + static_cast<size_t>(i) * f.stride);
+    }
+    f.lu.swap(ordered);
+    return f;
+}
+
+template <typename T>
+void luSolveFactors(const LUFactors<T> &factors, double *y, int count) {
+    int n = factors.n;
+    auto yrow = [y, count](int i) { return y + static_cast<size_t>(i) * count; };
+
+    // Y <- P*Y, replaying the swaps in the order they were made
+    for (int k = 0; k < n; ++k) {
+        int p = factors.pivots[k];
+        if (p != k) std::swap_ranges(yrow(k), yrow(k) + count, yrow(p));
+    }
+    // L*Z = P*Y (unit diagonal)
+    for (int i = 0; i < n; ++i) {
+        const T *li = factors.lu.data() + static_cast<size_t>(i) * factors.stride;
+        double *yi = yrow(i);
+        for (int j = 0; j < i; ++j) {
+            double l = li[j];
+            if (l == 0.0) continue;
+            const double *yj = yrow(j);
+            for (int c = 0; c < count; ++c) yi[c] -= l * yj[c];
+        }
+    }
+    // U*X = Z
+    for (int i = n - 1; i >= 0; --i) {
+        const T *ui = factors.lu.data() + static_cast<size_t>(i) * factors.stride;
+        double *yi = yrow(i);
+        for (int j = i + 1; j < n; ++j) {
+            double u = ui[j];
+            if (u == 0.0) continue;
+            const double *yj = yrow(j);
+            for (int c = 0; c < count; ++c) yi[c] -= u * yj[c];
+        }
+        double inv = 1.0 / ui[i];
+        for (int c = 0; c < count; ++c) yi[c] *= inv;
+    }
+}
+
+template void luUpdateTile<double>(std::vector<double *> &, int, int, int, int, int, int);
+template void luUpdateTile<float>(std::vector<float *> &, int, int, int, int, int, int);
+template void luFactorRows<double>(std::vector<double *> &, int, int, int, std::vector<int> &);
+template void luBackSubstitute<double>(const std::vector<double *> &, int, int, int);
+template LUFactors<double> luFactor<double>(const Matrix &, int);
+template void luSolveFactors<double>(const LUFactors<double> &, double *, int);
+template void luFactorRows<float>(std::vector<float *> &, int, int, int, std::vector<int> &);
+template LUFactors<float> luFactor<float>(const Matrix &, int);
+template void luSolveFactors<float>(const LUFactors<float> &, double *, int);
+
+template <typename T>
+double luConditionEstimate(const LUFactors<T> &factors, double normA1) {
+    auto row = [&factors](int i) { return factors.lu.data() + static_cast<size_t>(i) * factors.stride; };
+    return normA1 * inverse_norm1_estimate(row, factors.n);
+}
+
+template double luConditionEstimate<double>(const LUFactors<double> &, double);
+template double luConditionEstimate<float>(const LUFactors<float> &, double);
+
+double luConditionEstimate(const Matrix &factored, double normA1) {
+    auto row = [&factored](int i) { return factored.row(i); };
+    return normA1 * inverse_norm1_estimate(row, factored.n);
+}
+
+double norm1(const Matrix &matrix) {
+    std::vector<double> sums(matrix.n, 0.0);
+    for (int i = 0; i < matrix.n; ++i) {
+        const double *r = matrix.row(i);
+        for (int j = 0; j < matrix.n; ++j) sums[j] += std::abs(r[j]);
+    }
+    return sums.empty() ? 0.0 : *std::max_element(sums.begin(), sums.end());
+}
+
+void luSolveBlocked(Matrix &matrix, int blockSize) {
+    int n = matrix.n;
+    if (n == 0) return;
+
+    std::vector<double *> rows(n);
+    for (int i = 0; i < n; ++i) rows[i] = matrix.row(i);
+
+    std::vector<int> pivots;
+    // Sweep the full padded stride: B rides along as extra columns of the
+    // trailing updates (forward substitution for free), padding stays zero.
+    luFactorRows(rows, n, matrix.stride, blockSize, pivots);
+
+    // Mirror the pointer swaps in the matrix's own row permutation
+    for (int k = 0; k < n; ++k) {
+        if (pivots[k] != k) matrix.swapRows(k, pivots[k]);
+    }
+
+    luBackSubstitute(rows, n, n, matrix.rhs);
+}
@@ -0,0 +1,78 @@
+#ifndef SRC_LU_H
+#define SRC_LU_H
+
+#include <vector>
+#include "src_gauss_jordan.h"
+
+// Right-looking blocked LU factorization with partial pivoting: P*A = L*U.
+//
+// Work is done on an array of row pointers, so a row interchange is a pointer
+// swap. rows[i] must hold at least `width` elements; columns [0, n) are A and
+// columns [n, width) are carried along (right-hand sides, zero padding). After
+// the call the A part holds L (unit diagonal, below) and U (on/above), the
+// extra columns hold L^-1 * P * B, and pivots[k] is the row that was swapped
+// into position k at step k (LAPACK ipiv convention, 0-based).
+//
+// Each block of `blockSize` columns is factored unblocked (the panel), then
+// the block row of U is formed by a triangular solve and the trailing matrix
+// is updated by a register-blocked GEMM. Throws std::runtime_error when a
+// pivot is ~0.
+template <typename T>
+void luFactorRows(std::vector<T *> &rows, int n, int width, int blockSize, std::vector<int> &pivots);
+
+// C -= L * U on the same row-pointer view: rows [i0, i1) x columns [j0, j1)
+// minus rows[i][k0..k1) times rows[k0..k1)[j0..j1). The register-blocked
+// trailing update of luFactorRows, usable on one tile; tiles with disjoint
+// rows or columns may be updated concurrently.
+template <typename T>
+void luUpdateTile(std::vector<T *> &rows, int i0, int i1, int j0, int j1, int k0, int k1);
+
+// Back substitution U*X = Y for the `count` columns starting at `column` of
+// the factored rows; the solution overwrites Y in place.
+template <typename T>
+void luBackSubstitute(const std::vector<T *> &rows, int n, int column, int count = 1);
+
+// Factors of one coefficient matrix, kept apart from any right-hand side so
+// they can be reused: rows of `lu` are in pivoted order, L (unit diagonal)
+// below and U on/above the diagonal.
+template <typename T>
+struct LUFactors {
+    int n = 0;
+    int stride = 0;          // row length of `lu` (n rounded up to 8)
+    std::vector<T> lu;       // n x stride, row-major
+    std::vector<int> pivots; // swap sequence, see luFactorRows
+
+    size_t bytes() const { return lu.size() * sizeof(T) + pivots.size() * sizeof(int); }
+};
+
+// Factorize the A part of `matrix` (left untouched) in precision T.
+template <typename T>
+LUFactors<T> luFactor(const Matrix &matrix, int blockSize = 64);
+
+// Solve A*X = Y with existing factors: O(n^2) per column. Y is n x count,
+// row-major, and is overwritten with X.
+template <typename T>
+void luSolveFactors(const LUFactors<T> &factors, double *y, int count);
+
+// Solve [A|B] in place with the blocked LU. On return the right-hand-side
+// columns hold the solution X (so residualNorm works as for Gauss-Jordan), the
+// A part holds the L and U factors and the row order of `matrix` is P*A.
+void luSolveBlocked(Matrix &matrix, int blockSize = 64);
+
+// Max column sum ||A||_1 of the A part of `matrix`
+double norm1(const Matrix &matrix);
+
+// Estimate of the 1-norm condition number ||A||_1 * ||A^-1||_1 from existing
+// factors, in O(n^2): ||A^-1||_1 is estimated by Hager's method as refined by
+// Higham (LAPACK dlacn2), a few solves with L*U and its transpose, so it is
+// cheap next to the factorization. `normA1` is norm1() of the original A. The
+// estimate is a lower bound and nearly always within a factor of 3; the
+// relative forward error of a solve is roughly estimate * machine epsilon.
+template <typename T>
+double luConditionEstimate(const LUFactors<T> &factors, double normA1);
+
+// Same for a matrix after luSolveBlocked(): its A part holds L and U in
+// pivoted row order. Call norm1() before the solve.
+double luConditionEstimate(const Matrix &factored, double normA1);
+
+#endif // SRC_LU_H
@@ -0,0 +1,188 @@
+#include "src_matrix_gen.h"
+#include "src_thread_pool.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+
+// Philox streams of the two reflector vectors (entries use kPhiloxStreamEntries)
+constexpr uint32_t kStreamU = 1;
+constexpr uint32_t kStreamV = 2;
+
+// Below this many entries a system is not worth a pool round trip
+constexpr double kParallelFillEntries = 1 << 16;
+
+// Columns [c0, c1) of `stream`'s row i, one Philox call per column pair
+void uniformRange(uint64_t seed, uint32_t stream, int i, int c0, int c1, double low, double high, double *out) {
+    int c = c0;
+    if (c < c1 && (c & 1)) {
+        out[c] = philoxUniform(seed, stream, i, c, low, high);
+        ++c;
+    }
+    for (; c + 1 < c1; c += 2) {
+        PhiloxCounter w = philox4x32({static_cast<uint32_t>(c / 2), static_cast<uint32_t>(i), stream, 0}, seed);
+        out[c] = low + (high - low) * philoxUnit(w[0], w[1]);
+        out[c + 1] = low + (high - low) * philoxUnit(w[2], w[3]);
+    }
+    if (c < c1) out[c] = philoxUniform(seed, stream, i, c, low, high);
+}
+
+// Unit vector of uniform(-1, 1) entries
+std::vector<double> randomUnitVector(uint64_t seed, uint32_t stream, int n) {
+    std::vector<double> x(n);
+    uniformRange(seed, stream, 0, 0, n, -1.0, 1.0, x.data());
+    double norm = 0.0;
+    for (double v : x) norm += v * v;
+    norm = std::sqrt(norm);
+    if (norm == 0.0) throw std::runtime_error("Degenerate reflector in the matrix generator.");
+    for (double &v : x) v /= norm;
+    return x;
+}
+
+} // namespace
+
+const char *matrixKindName(MatrixKind kind) {
+    switch (kind) {
+    case MatrixKind::Dense: return "dense";
+    case MatrixKind::Banded: return "banded";
+    case MatrixKind::Spd: return "spd";
+    case MatrixKind::IllConditioned: return "illcond";
+    }
+    return "?";
+}
+
+bool parseMatrixKind(const char *name, MatrixKind &kind) {
+    const MatrixKind all[] = {MatrixKind::Dense, MatrixKind::Banded, MatrixKind::Spd, MatrixKind::IllConditioned};
+    for (MatrixKind k : all) {
+        if (std::strcmp(name, matrixKindName(k)) == 0) {
+            kind = k;
+            return true;
+        }
+    }
+    return false;
+}
+
+MatrixGenerator::MatrixGenerator(int size, int rhsCount, uint64_t seed, const MatrixGenOptions &options)
+    : n(size), rhs(rhsCount), seed_(seed), options_(options) {
+    if (size < 0 || rhsCount < 0) throw std::invalid_argument("Matrix size must be >= 0.");
+    if (options.kind == MatrixKind::Banded && options.bandwidth < 0) {
+        throw std::invalid_argument("Bandwidth must be >= 0.");
+    }
+    if (options.kind == MatrixKind::IllConditioned && n > 0) {
+        if (!(options.condition >= 1.0)) throw std::invalid_argument("Condition number must be >= 1.");
+        u_ = randomUnitVector(seed, kStreamU, n);
+        v_ = randomUnitVector(seed, kStreamV, n);
+        sigma_.resize(n);
+        for (int k = 0; k < n; ++k) {
+            sigma_[k] = n > 1 ? std::pow(options.condition, -static_cast<double>(k) / (n - 1)) : 1.0;
+            uSigmaV_ += u_[k] * sigma_[k] * v_[k];
+        }
+    }
+}
+
+double MatrixGenerator::householderEntry(int i, int j) const {
+    // (I - 2uu^T) S (I - 2vv^T), expanded so that no n x n product is formed
+    double svv = sigma_[i] * ((i == j ? 1.0 : 0.0) - 2.0 * v_[i] * v_[j]);
+    return svv - 2.0 * u_[i] * (u_[j] * sigma_[j] - 2.0 * v_[j] * uSigmaV_);
+}
+
+void MatrixGenerator::row(int i, double *out) const {
+    const double low = options_.low, high = options_.high;
+    uniformRange(seed_, kPhiloxStreamEntries, i, n, n + rhs, low, high, out);
+
+    switch (options_.kind) {
+    case MatrixKind::Dense:
+    case MatrixKind::Banded: {
+        int c0 = 0, c1 = n;
+        if (options_.kind == MatrixKind::Banded) {
+            c0 = std::max(0, i - options_.bandwidth);
+            c1 = std::min(n, i + options_.bandwidth + 1);
+            std::fill(out, out + c0, 0.0);
+            std::fill(out + c1, out + n, 0.0);
+        }
+        uniformRange(seed_, kPhiloxStreamEntries, i, c0, c1, low, high, out);
+        if (options_.diagonallyDominant) {
+            double row_abs_sum = 0.0;
+            for (int j = c0; j < c1; ++j) row_abs_sum += std::fabs(out[j]);
+            out[i] += row_abs_sum + 1.0;
+        }
+        break;
+    }
+    case MatrixKind::Spd: {
+        // a_ij and a_ji both come from the counter of (min(i,j), max(i,j))
+        uniformRange(seed_, kPhiloxStreamEntries, i, i, n, low, high, out);
+        double row_abs_sum = 0.0;
+        for (int j = 0; j < i; ++j) {
+            out[j] = philoxUniform(seed_, kPhiloxStreamEntries, j, i, low, high);
+            row_abs_sum += std::fabs(out[j]);
+        }
+        for (int j = i + 1; j < n; ++j) row_abs_sum += std::fabs(out[j]);
+        out[i] = std::fabs(out[i]) + row_abs_sum + 1.0;
+        break;
+    }
+    case MatrixKind::IllConditioned:
+        for (int j = 0; j < n; ++j) out[j] = householderEntry(i, j);
+        break;
+    }
+}
+
+void fillSystem(Matrix &matrix, const MatrixGenerator &generator, ThreadPool &pool) {
+    if (matrix.n != generator.n || matrix.rhs != generator.rhs) {
+        throw std::invalid_argument("Matrix size does not match the generator.");
+    }
+    unsigned threadCount = pool.size();
+    pool.run([&](unsigned tid) {
+        int begin, end;
+        splitRange(matrix.n, threadCount, tid, begin, end);
+        for (int i = begin; i < end; ++i) generator.row(i, matrix.row(i));
+    });
+}
+
+void fillSystem(Matrix &matrix, const MatrixGenerator &generator, unsigned threadCount) {
+    if (matrix.n != generator.n || matrix.rhs != generator.rhs) {
+        throw std::invalid_argument("Matrix size does not match the generator.");
+    }
+    if (threadCount == 0) {
+        unsigned hw = std::thread::hardware_concurrency();
+        threadCount = hw > 0 ? hw : 1;
+    }
+    if (static_cast<double>(matrix.n) * matrix.cols < kParallelFillEntries) threadCount = 1;
+    threadCount = std::min(threadCount, static_cast<unsigned>(std::max(matrix.n, 1)));
+
+    if (threadCount == 1) {
+        for (int i = 0; i < matrix.n; ++i) generator.row(i, matrix.row(i));
+    } else {
+        fillSystem(matrix, generator, ThreadPool::shared(threadCount));
+    }
+}
+
+Matrix generateSystem(const MatrixGenerator &generator, ThreadPool &pool) {
+    const int n = generator.n;
+    const int cols = n + generator.rhs;
+    const size_t width = static_cast<size_t>(cols + Matrix::kSimdWidth - 1) / Matrix::kSimdWidth * Matrix::kSimdWidth;
+    size_t bytes = static_cast<size_t>(n) * width * sizeof(double);
+    if (bytes == 0) return Matrix(n, generator.rhs);
+
+    // Not zero-filled: the owning thread's first write places each page
+    void *p = std::aligned_alloc(Matrix::kAlignment, bytes);
+    if (!p) throw std::bad_alloc();
+    std::shared_ptr<double> buffer(static_cast<double *>(p), [](double *q) { std::free(q); });
+
+    double *base = buffer.get();
+    unsigned threadCount = pool.size();
+    pool.run([&](unsigned tid) {
+        int begin, end;
+        splitRange(n, threadCount, tid, begin, end);
+        for (int i = begin; i < end; ++i) {
+            double *r = base + static_cast<size_t>(i) * width;
+            generator.row(i, r);
+            std::fill(r + cols, r + width, 0.0);
+        }
+    });
+    return Matrix::fromBuffer(n, generator.rhs, std::move(buffer));
+}
@@ -0,0 +1,122 @@
+#ifndef SRC_MATRIX_GEN_H
+#define SRC_MATRIX_GEN_H
+
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "src_gauss_jordan.h"
+
+class ThreadPool;
+
+// Test systems from a counter-based generator: every entry is a pure function
+// of (seed, row, column), so rows can be produced in any order, by any thread,
+// and the matrix for a given seed is the same whatever the thread count.
+//
+// The generator is Philox4x32-10 (Salmon, Moraes, Dror, Shaw, "Parallel random
+// numbers: as easy as 1, 2, 3", SC'11): ten rounds of a keyed bijection on a
+// 128-bit counter, giving four 32-bit words per counter value.
+
+using PhiloxCounter = std::array<uint32_t, 4>;
+
+inline uint32_t philoxMulHiLo(uint32_t a, uint32_t b, uint32_t &lo) {
+    uint64_t product = static_cast<uint64_t>(a) * b;
+    lo = static_cast<uint32_t>(product);
+    return static_cast<uint32_t>(product >> 32);
+}
+
+inline PhiloxCounter philox4x32(PhiloxCounter c, uint64_t key) {
+    uint32_t k0 = static_cast<uint32_t>(key), k1 = static_cast<uint32_t>(key >> 32);
+    for (int round = 0; round < 10; ++round) {
+        if (round > 0) {
+            k0 += 0x9E3779B9u;
+            k1 += 0xBB67AE85u;
+        }
+        uint32_t lo0, lo1;
+        uint32_t hi0 = philoxMulHiLo(0xD2511F53u, c[0], lo0);
+        uint32_t hi1 = philoxMulHiLo(0xCD9E8D57u, c[2], lo1);
+        c = {hi1 ^ c[1] ^ k0, lo1, hi0 ^ c[3] ^ k1, lo0};
+    }
+    return c;
+}
+
+// Uniform double in [0, 1) from 53 bits of two words
+inline double philoxUnit(uint32_t hi, uint32_t lo) {
+    return static_cast<double>(((static_cast<uint64_t>(hi) << 32) | lo) >> 11) * 0x1.0p-53;
+}
+
+// Stream of the entries of [A|B]: element (i, j) is philoxUniform(seed,
+// kPhiloxStreamEntries, i, j, ...) before any diagonal shift
+constexpr uint32_t kPhiloxStreamEntries = 0;
+
+// Uniform value in [low, high) for element (row, col) of `stream`. One counter
+// value covers two neighbouring columns; see MatrixGenerator::row for filling
+// a whole row with half the Philox calls.
+inline double philoxUniform(uint64_t seed, uint32_t stream, uint32_t row, uint32_t col, double low, double high) {
+    PhiloxCounter w = philox4x32({col / 2, row, stream, 0}, seed);
+    int h = (col & 1) * 2;
+    return low + (high - low) * philoxUnit(w[h], w[h + 1]);
+}
+
+enum class MatrixKind {
+    Dense,          // uniform entries
+    Banded,         // uniform entries for |i - j| <= bandwidth, zero outside
+    Spd,            // symmetric, positive diagonal, strictly diagonally dominant
+    IllConditioned, // U * diag(sigma) * V^T with sigma from 1 down to 1/condition
+};
+
+const char *matrixKindName(MatrixKind kind);
+
+// Parse "dense", "banded", "spd" or "illcond"; returns false on unknown names
+bool parseMatrixKind(const char *name, MatrixKind &kind);
+
+struct MatrixGenOptions {
+    MatrixKind kind = MatrixKind::Dense;
+    double low = -10.0;              // range of the random entries of A and B
+    double high = 10.0;
+    bool diagonallyDominant = true;  // Dense/Banded: add the row's |sum| + 1 to the diagonal
+    int bandwidth = 8;               // Banded: half bandwidth
+    double condition = 1e8;          // IllConditioned: 2-norm condition number of A
+};
+
+// Rows of one random system [A|B] (n x (n + rhs)). The constructor does the
+// O(n) set-up some kinds need (the reflectors of IllConditioned); row() is
+// then const and may be called concurrently.
+//
+// IllConditioned follows LAPACK's dlatms: A = (I - 2uu^T) diag(sigma)
+// (I - 2vv^T) with random unit u and v and sigma_k = condition^(-k/(n-1)).
+// Two Householder reflectors make the singular vectors dense while any entry
+// stays O(1) to compute, and cond_2(A) is exactly `condition` (up to rounding).
+class MatrixGenerator {
+public:
+    int n;
+    int rhs;
+
+    MatrixGenerator(int size, int rhsCount, uint64_t seed, const MatrixGenOptions &options = MatrixGenOptions());
+
+    // Row i of [A|B] into out[0, n + rhs)
+    void row(int i, double *out) const;
+
+    const MatrixGenOptions &options() const { return options_; }
+
+private:
+    double householderEntry(int i, int j) const;
+
+    uint64_t seed_;
+    MatrixGenOptions options_;
+    std::vector<double> u_, v_, sigma_; // IllConditioned only
+    double uSigmaV_ = 0.0;              // sum_k u_k sigma_k v_k
+};
+
+// Fill the rows of `matrix` from `generator` (sizes must match), row blocks
+// split over the pool as in gaussJordanParallel()
+void fillSystem(Matrix &matrix, const MatrixGenerator &generator, ThreadPool &pool);
+// Same on ThreadPool::shared(threadCount) (0 = hardware_concurrency); small
+// systems are filled on the calling thread
+void fillSystem(Matrix &matrix, const MatrixGenerator &generator, unsigned threadCount = 0);
+
+// A new system generated in a buffer nobody has touched yet: each pool thread
+// writes, and so first-touches, the rows gaussJordanParallel() will give it on
+// the same pool (see copyFirstTouch in src_numa.h)
+Matrix generateSystem(const MatrixGenerator &generator, ThreadPool &pool);
+
+#endif // SRC_MATRIX_GEN_H
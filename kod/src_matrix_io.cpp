@@ -0,0 +1,167 @@
+#include "src_matrix_io.h"
+#include "src_matrix_gen.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define GJ_HAVE_MMAP 1
+#endif
+
+static_assert(sizeof(MatrixFileHeader) == 64, "MatrixFileHeader must stay 64 bytes");
+
+namespace {
+
+constexpr char kMagic[8] = {'G', 'J', 'M', 'A', 'T', 'R', 'I', 'X'};
+constexpr size_t kWriteBufferBytes = size_t(1) << 20;
+
+using FilePtr = std::unique_ptr<std::FILE, int (*)(std::FILE *)>;
+
+FilePtr openFile(const std::string &path, const char *mode) {
+    FilePtr f(std::fopen(path.c_str(), mode), &std::fclose);
+    if (!f) throw std::runtime_error("Cannot open " + path);
+    return f;
+}
+
+MatrixFileHeader makeHeader(uint64_t rows, uint64_t columns, uint64_t rhs) {
+    MatrixFileHeader h;
+    std::memset(&h, 0, sizeof(h));
+    std::memcpy(h.magic, kMagic, sizeof(kMagic));
+    h.version = kMatrixFileVersion;
+    h.dtype = kDtypeFloat64;
+    h.rows = rows;
+    h.columns = columns;
+    h.rhs = rhs;
+    h.stride = (columns + rhs + Matrix::kSimdWidth - 1) / Matrix::kSimdWidth * Matrix::kSimdWidth;
+    h.alignment = Matrix::kAlignment;
+    h.dataOffset = kMatrixFileDataOffset;
+    return h;
+}
+
+// Header, zero fill up to dataOffset, then rows[i] = row(i) + first, `count` values each
+template <typename RowFn>
+void writeRows(const std::string &path, const MatrixFileHeader &h, RowFn row, size_t count) {
+    FilePtr f = openFile(path, "wb");
+    std::vector<char> page(h.dataOffset, 0);
+    std::memcpy(page.data(), &h, sizeof(h));
+    bool ok = std::fwrite(page.data(), 1, page.size(), f.get()) == page.size();
+
+    std::vector<double> buffer;
+    buffer.reserve(std::max<size_t>(h.stride, kWriteBufferBytes / sizeof(double)) + h.stride);
+    for (uint64_t i = 0; ok && i < h.rows; ++i) {
+        const double *src = row(static_cast<int>(i));
+        buffer.insert(buffer.end(), src, src + count);
+        buffer.resize(buffer.size() + (h.stride - count), 0.0);
+        if (buffer.size() * sizeof(double) >= kWriteBufferBytes || i + 1 == h.rows) {
+            ok = std::fwrite(buffer.data(), sizeof(double), buffer.size(), f.get()) == buffer.size();
+            buffer.clear();
+        }
+    }
+    if (!ok || std::fflush(f.get()) != 0) throw std::runtime_error("Write failed: " + path);
+}
+
+void checkHeader(const MatrixFileHeader &h, uint64_t fileSize, const std::string &path) {
+    if (std::memcmp(h.magic, kMagic, sizeof(kMagic)) != 0) throw std::runtime_error(path + " is not a matrix file");
+    if (h.version != kMatrixFileVersion) throw std::runtime_error(path + ": unsupported format version");
+    if (h.dtype != kDtypeFloat64) throw std::runtime_error(path + ": unsupported element type");
+    if (h.columns != h.rows) throw std::runtime_error(path + " does not hold a square system [A|B]");
+    // Every count must fit an int (Matrix sizes, row loops), and rows * stride
+    // bytes must not wrap around before the comparison with the file size
+    if (h.rows > INT32_MAX || h.rhs > INT32_MAX - h.rows || h.stride < h.columns + h.rhs ||
+        h.stride > INT32_MAX) {
+        throw std::runtime_error(path + ": bad dimensions");
+    }
+    if (h.stride != 0 && h.rows > UINT64_MAX / sizeof(double) / h.stride) {
+        throw std::runtime_error(path + ": bad dimensions");
+    }
+    uint64_t bytes = h.rows * h.stride * sizeof(double);
+    if (h.dataOffset < sizeof(MatrixFileHeader) || fileSize < h.dataOffset || fileSize - h.dataOffset < bytes) {
+        throw std::runtime_error(path + " is truncated");
+    }
+}
+
+} // namespace
+
+void saveMatrix(const Matrix &matrix, const std::string &path) {
+    MatrixFileHeader h = makeHeader(matrix.n, matrix.n, matrix.rhs);
+    writeRows(path, h, [&matrix](int i) { return matrix.row(i); }, matrix.cols);
+}
+
+void saveSolution(const Matrix &matrix, const std::string &path) {
+    MatrixFileHeader h = makeHeader(matrix.n, 0, matrix.rhs);
+    writeRows(path, h, [&matrix](int i) { return matrix.row(i) + matrix.n; }, matrix.rhs);
+}
+
+void saveSolution(const std::vector<double> &x, int n, int rhs, const std::string &path) {
+    if (x.size() != static_cast<size_t>(n) * rhs) throw std::invalid_argument("Solution block has the wrong size.");
+    MatrixFileHeader h = makeHeader(n, 0, rhs);
+    writeRows(path, h, [&x, rhs](int i) { return x.data() + static_cast<size_t>(i) * rhs; }, rhs);
+}
+
+void saveRandomSystem(int n, int rhs, double low, double high, uint64_t seed, const std::string &path) {
+    MatrixFileHeader h = makeHeader(n, n, rhs);
+    MatrixGenOptions options;
+    options.low = low;
+    options.high = high;
+    MatrixGenerator generator(n, rhs, seed, options);
+    std::vector<double> row(static_cast<size_t>(n) + rhs);
+    writeRows(path, h, [&](int i) {
+        generator.row(i, row.data());
+        return static_cast<const double *>(row.data());
+    }, row.size());
+}
+
+MatrixFileHeader readMatrixHeader(const std::string &path) {
+    FilePtr f = openFile(path, "rb");
+    MatrixFileHeader h;
+    if (std::fread(&h, sizeof(h), 1, f.get()) != 1) throw std::runtime_error(path + " is truncated");
+    std::fseek(f.get(), 0, SEEK_END);
+    uint64_t fileSize = static_cast<uint64_t>(std::ftell(f.get()));
+    checkHeader(h, fileSize, path);
+    return h;
+}
+
+Matrix loadMatrix(const std::string &path) {
+    MatrixFileHeader h = readMatrixHeader(path);
+    FilePtr f = openFile(path, "rb");
+
+    int n = static_cast<int>(h.rows);
+    int rhs = static_cast<int>(h.rhs);
+    uint64_t expectedStride = (h.rows + h.rhs + Matrix::kSimdWidth - 1) / Matrix::kSimdWidth * Matrix::kSimdWidth;
+    size_t dataBytes = static_cast<size_t>(h.rows * h.stride * sizeof(double));
+
+#if defined(GJ_HAVE_MMAP)
+    bool sameLayout = h.stride == expectedStride && h.alignment % Matrix::kAlignment == 0 &&
+                      h.dataOffset % static_cast<uint64_t>(sysconf(_SC_PAGESIZE)) == 0;
+    if (sameLayout && dataBytes > 0) {
+        // Map only the rows; private pages are copied on the first write
+        void *p = mmap(nullptr, dataBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE, fileno(f.get()),
+                       static_cast<off_t>(h.dataOffset));
+        if (p != MAP_FAILED) {
+            std::shared_ptr<double> buffer(static_cast<double *>(p),
+                                           [dataBytes](double *q) { munmap(q, dataBytes); });
+            return Matrix::fromBuffer(n, rhs, std::move(buffer));
+        }
+    }
+#endif
+
+    // Different stride (or no mmap): read row by row into Matrix storage
+    Matrix m(n, rhs);
+    std::vector<double> row(h.stride);
+    std::fseek(f.get(), static_cast<long>(h.dataOffset), SEEK_SET);
+    for (int i = 0; i < n; ++i) {
+        if (std::fread(row.data(), sizeof(double), row.size(), f.get()) != row.size()) {
+            throw std::runtime_error(path + " is truncated");
+        }
+        std::copy(row.begin(), row.begin() + m.cols, m.row(i));
+    }
+    return m;
+}
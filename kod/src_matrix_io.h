@@ -0,0 +1,61 @@
+#ifndef SRC_MATRIX_IO_H
+#define SRC_MATRIX_IO_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "src_gauss_jordan.h"
+
+// Binary file format for augmented systems [A|B] and for solutions X.
+//
+//   offset 0     MatrixFileHeader (64 bytes, little-endian)
+//   dataOffset   `rows` rows of `stride` elements each, row-major, padding zero
+//
+// A system file stores n rows of n + rhs values (columns = n); a solution file
+// stores n rows of rhs values (columns = 0). The writer uses Matrix's own row
+// layout (stride rounded up to 8 doubles, data starting on a page boundary), so
+// loadMatrix() can map the file and hand the pages straight to the solver.
+struct MatrixFileHeader {
+    char magic[8];       // "GJMATRIX"
+    uint32_t version;    // kMatrixFileVersion
+    uint32_t dtype;      // kDtypeFloat64 (the only type written so far)
+    uint64_t rows;       // n
+    uint64_t columns;    // columns of A: n for a system, 0 for a solution
+    uint64_t rhs;        // right-hand-side columns
+    uint64_t stride;     // elements per stored row
+    uint32_t alignment;  // bytes; every row starts on a multiple of it
+    uint32_t reserved;
+    uint64_t dataOffset; // bytes from the start of the file to row 0
+};
+
+constexpr uint32_t kMatrixFileVersion = 1;
+constexpr uint32_t kDtypeFloat64 = 1;
+constexpr uint64_t kMatrixFileDataOffset = 4096;
+
+// Write [A|B] in logical row order, one row at a time through a fixed buffer
+// (no copy of the whole matrix). Throws std::runtime_error on I/O errors.
+void saveMatrix(const Matrix &matrix, const std::string &path);
+
+// Same rows as Matrix::fillRandom(low, high, seed) on an n x (n + rhs)
+// system, generated and written one row at a time: for systems that do not
+// fit in memory (see src_out_of_core.h).
+void saveRandomSystem(int n, int rhs, double low, double high, uint64_t seed, const std::string &path);
+
+// Read and validate the header of a system file; throws std::runtime_error
+// for a missing, truncated or foreign file.
+MatrixFileHeader readMatrixHeader(const std::string &path);
+
+// Map a system file into a Matrix. When the stored layout matches Matrix's,
+// the mapping itself becomes the storage (MAP_PRIVATE: solving in place never
+// writes back to the file) and is unmapped with the last copy of the buffer;
+// otherwise, or without mmap, rows are read into a fresh Matrix.
+// Throws std::runtime_error for a missing, truncated or foreign file.
+Matrix loadMatrix(const std::string &path);
+
+// Stream the solution block X (the right-hand-side columns of a solved
+// matrix) to `path` as a solution file, row by row.
+void saveSolution(const Matrix &matrix, const std::string &path);
+// Same for a solution block X (n x rhs, row-major) held outside a Matrix
+void saveSolution(const std::vector<double> &x, int n, int rhs, const std::string &path);
+
+#endif // SRC_MATRIX_IO_H
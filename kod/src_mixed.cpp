@@ -0,0 +1,84 @@
+#include "src_mixed.h"
+#include "src_lu.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+
+double frobeniusA(const Matrix &matrix) {
+    double sumsq = 0.0;
+    for (int i = 0; i < matrix.n; ++i) {
+        const double *a = matrix.row(i);
+        for (int j = 0; j < matrix.n; ++j) sumsq += a[j] * a[j];
+    }
+    return std::sqrt(sumsq);
+}
+
+double frobenius(const std::vector<double> &v) {
+    double sumsq = 0.0;
+    for (double x : v) sumsq += x * x;
+    return std::sqrt(sumsq);
+}
+
+void storeSolution(Matrix &matrix, const std::vector<double> &x) {
+    int n = matrix.n;
+    for (int i = 0; i < n; ++i) {
+        std::copy(x.begin() + static_cast<size_t>(i) * matrix.rhs,
+                  x.begin() + static_cast<size_t>(i + 1) * matrix.rhs, matrix.row(i) + n);
+    }
+}
+
+} // namespace
+
+MixedSolveInfo solveMixedPrecision(Matrix &matrix, double tolerance, int maxSteps, int blockSize) {
+    MixedSolveInfo info;
+    int n = matrix.n;
+    if (n == 0) return info;
+    if (tolerance <= 0.0) tolerance = std::numeric_limits<double>::epsilon() * std::sqrt(static_cast<double>(n));
+
+    const std::vector<double> b = matrix.solutionBlock(); // B before X overwrites it
+    const double normA = frobeniusA(matrix);
+    std::vector<double> x = b;
+    std::vector<double> r;
+
+    bool converged = false;
+    try {
+        LUFactors<float> factors = luFactor<float>(matrix, blockSize);
+        luSolveFactors(factors, x.data(), matrix.rhs);
+
+        std::vector<double> d;
+        double norm = residualBlock(matrix, x, r);
+        // Stop as soon as X meets the target (this also covers R = 0)
+        converged = norm <= tolerance * normA * frobenius(x);
+        while (!converged && info.refinementSteps < maxSteps) {
+            // d = A^-1 R in float precision, then keep X + d only if it at least halves R
+            d = r;
+            luSolveFactors(factors, d.data(), matrix.rhs);
+            for (size_t k = 0; k < x.size(); ++k) x[k] += d[k];
+            double next = residualBlock(matrix, x, r);
+            if (!(next <= 0.5 * norm)) {
+                for (size_t k = 0; k < x.size(); ++k) x[k] -= d[k];
+                break; // at the double round-off floor, or float cannot carry this system
+            }
+            norm = next;
+            ++info.refinementSteps;
+            converged = norm <= tolerance * normA * frobenius(x);
+        }
+        info.residual = norm;
+    } catch (const std::runtime_error &) {
+        // Pivot underflowed in float; the double factorization decides whether A is singular
+    }
+
+    if (!converged) {
+        info.fellBack = true;
+        x = b;
+        LUFactors<double> factors = luFactor<double>(matrix, blockSize);
+        luSolveFactors(factors, x.data(), matrix.rhs);
+        info.residual = residualBlock(matrix, x, r);
+    }
+
+    storeSolution(matrix, x);
+    return info;
+}
@@ -0,0 +1,30 @@
+#ifndef SRC_MIXED_H
+#define SRC_MIXED_H
+
+#include "src_gauss_jordan.h"
+
+// Outcome of a mixed-precision solve
+struct MixedSolveInfo {
+    int refinementSteps = 0; // corrections applied on top of the float solution
+    bool fellBack = false;   // refinement stalled, X comes from a double LU
+    double residual = 0.0;   // ||B - A*X||_F of the returned X
+};
+
+// Solve [A|B] with A factorized in float (half the bytes per element and twice
+// the SIMD lanes of double) and the solution refined in double:
+//
+//   X = LU_f \ B;   repeat  R = B - A*X (double),  X += LU_f \ R
+//
+// X is accepted once ||R||_F <= tolerance * ||A||_F * ||X||_F (checked before
+// every correction, so an exact X needs none); tolerance = 0 selects
+// eps(double) * sqrt(n), the LAPACK dsgesv criterion. Refinement gives up when
+// a correction fails to at least halve ||R||_F or after maxSteps corrections;
+// then, or when the float factorization fails, the system is solved again with
+// a double LU.
+//
+// Like FactorizationCache::solve, the right-hand-side columns receive X and the
+// A part is left untouched. Throws std::runtime_error for a singular A.
+MixedSolveInfo solveMixedPrecision(Matrix &matrix, double tolerance = 0.0, int maxSteps = 30,
+                                   int blockSize = 64);
+
+#endif // SRC_MIXED_H
@@ -0,0 +1,182 @@
+#include "src_numa.h"
+#include "src_thread_pool.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <new>
+#include <set>
+#include <sstream>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+
+bool readFirstLine(const std::string &path, std::string &line) {
+    std::ifstream in(path);
+    return in && std::getline(in, line);
+}
+
+// CPUs the process may run on
+std::set<int> usableCpus() {
+    std::set<int> cpus;
+#if defined(__linux__)
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    if (sched_getaffinity(0, sizeof(mask), &mask) == 0) {
+        for (int c = 0; c < CPU_SETSIZE; ++c) {
+            if (CPU_ISSET(c, &mask)) cpus.insert(c);
+        }
+    }
+#endif
+    if (cpus.empty()) {
+        unsigned hw = std::thread::hardware_concurrency();
+        for (unsigned c = 0; c < std::max(hw, 1u); ++c) cpus.insert(static_cast<int>(c));
+    }
+    return cpus;
+}
+
+#if defined(__linux__)
+bool setAffinity(const std::vector<int> &cpus) {
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    for (int c : cpus) {
+        if (c >= 0 && c < CPU_SETSIZE) CPU_SET(c, &mask);
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(mask), &mask) == 0;
+}
+#endif
+
+} // namespace
+
+std::vector<int> parseCpuList(const std::string &list) {
+    std::vector<int> cpus;
+    std::stringstream in(list);
+    std::string item;
+    while (std::getline(in, item, ',')) {
+        if (item.empty() || item == "\n") continue;
+        size_t dash = item.find('-');
+        try {
+            int first = std::stoi(item.substr(0, dash));
+            int last = dash == std::string::npos ? first : std::stoi(item.substr(dash + 1));
+            for (int c = first; c <= last; ++c) cpus.push_back(c);
+        } catch (...) {
+            // malformed entry: skip it
+        }
+    }
+    return cpus;
+}
+
+NumaTopology NumaTopology::read(const std::string &nodeDir) {
+    NumaTopology topo;
+    std::set<int> usable = usableCpus();
+    std::string online;
+    if (readFirstLine(nodeDir + "/online", online)) {
+        for (int id : parseCpuList(online)) {
+            std::string list;
+            if (!readFirstLine(nodeDir + "/node" + std::to_string(id) + "/cpulist", list)) continue;
+            NumaNode node{id, {}};
+            for (int c : parseCpuList(list)) {
+                if (usable.count(c)) node.cpus.push_back(c);
+            }
+            if (!node.cpus.empty()) topo.nodes.push_back(std::move(node));
+        }
+    }
+    if (topo.nodes.empty()) topo.nodes.push_back(NumaNode{0, std::vector<int>(usable.begin(), usable.end())});
+    return topo;
+}
+
+const NumaTopology &NumaTopology::system() {
+    static const NumaTopology topo = read("/sys/devices/system/node");
+    return topo;
+}
+
+int NumaTopology::nodeOfCpu(int cpu) const {
+    for (const NumaNode &node : nodes) {
+        if (std::find(node.cpus.begin(), node.cpus.end(), cpu) != node.cpus.end()) return node.id;
+    }
+    return -1;
+}
+
+std::vector<int> NumaTopology::placement(unsigned threads) const {
+    std::vector<int> cpus;
+    cpus.reserve(threads);
+    unsigned parts = static_cast<unsigned>(nodes.size());
+    for (unsigned i = 0; i < parts; ++i) {
+        int begin, end;
+        splitRange(static_cast<int>(threads), parts, i, begin, end);
+        const std::vector<int> &own = nodes[i].cpus;
+        for (int t = begin; t < end; ++t) cpus.push_back(own[static_cast<size_t>(t - begin) % own.size()]);
+    }
+    return cpus;
+}
+
+std::string NumaTopology::describe() const {
+    std::ostringstream out;
+    out << nodes.size() << (nodes.size() == 1 ? " node:" : " nodes:");
+    for (const NumaNode &node : nodes) {
+        out << ' ' << node.id << '[';
+        for (size_t i = 0; i < node.cpus.size();) {
+            size_t j = i;
+            while (j + 1 < node.cpus.size() && node.cpus[j + 1] == node.cpus[j] + 1) ++j;
+            out << (i ? "," : "") << node.cpus[i];
+            if (j > i) out << '-' << node.cpus[j];
+            i = j + 1;
+        }
+        out << ']';
+    }
+    return out.str();
+}
+
+bool pinCurrentThread(int cpu) {
+#if defined(__linux__)
+    return setAffinity({cpu});
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+ScopedCpuPin::ScopedCpuPin(int cpu) {
+#if defined(__linux__)
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    if (pthread_getaffinity_np(pthread_self(), sizeof(mask), &mask) != 0) return;
+    for (int c = 0; c < CPU_SETSIZE; ++c) {
+        if (CPU_ISSET(c, &mask)) previous_.push_back(c);
+    }
+    if (!pinCurrentThread(cpu)) previous_.clear();
+#else
+    (void)cpu;
+#endif
+}
+
+ScopedCpuPin::~ScopedCpuPin() {
+#if defined(__linux__)
+    if (!previous_.empty()) setAffinity(previous_);
+#endif
+}
+
+Matrix copyFirstTouch(const Matrix &src, ThreadPool &pool) {
+    const int n = src.n;
+    const size_t width = src.stride;
+    size_t bytes = static_cast<size_t>(n) * width * sizeof(double);
+    if (bytes == 0) return Matrix(n, src.rhs);
+
+    // Deliberately not zero-filled here: the first write decides the page's node
+    void *p = std::aligned_alloc(Matrix::kAlignment, bytes);
+    if (!p) throw std::bad_alloc();
+    std::shared_ptr<double> buffer(static_cast<double *>(p), [](double *q) { std::free(q); });
+
+    double *base = buffer.get();
+    unsigned threadCount = pool.size();
+    pool.run([&](unsigned tid) {
+        int begin, end;
+        splitRange(n, threadCount, tid, begin, end);
+        for (int r = begin; r < end; ++r) std::memcpy(base + r * width, src.row(r), width * sizeof(double));
+    });
+    return Matrix::fromBuffer(n, src.rhs, std::move(buffer));
+}
@@ -0,0 +1,67 @@
+#ifndef SRC_NUMA_H
+#define SRC_NUMA_H
+
+#include <string>
+#include <vector>
+#include "src_gauss_jordan.h"
+
+class ThreadPool;
+
+struct NumaNode {
+    int id;
+    std::vector<int> cpus; // CPUs of the node this process may run on
+};
+
+// NUMA layout as listed in /sys/devices/system/node (nodeN/cpulist), limited
+// to the process's CPU affinity mask. Without that directory (not Linux, no
+// NUMA support) the machine is one node holding every usable CPU.
+class NumaTopology {
+public:
+    std::vector<NumaNode> nodes; // nodes with at least one usable CPU
+
+    // Topology of this machine, read once
+    static const NumaTopology &system();
+    // Topology under another sysfs node directory (e.g. a copy for testing)
+    static NumaTopology read(const std::string &nodeDir);
+
+    // Node of `cpu`, -1 if it is not a usable CPU
+    int nodeOfCpu(int cpu) const;
+
+    // CPU for each of `threads` pool threads. Threads are dealt to the nodes
+    // in contiguous groups (splitRange over the nodes), so the neighbouring
+    // row blocks that splitRange hands to neighbouring threads share a node
+    // and every node's memory controller gets a share of the rows.
+    std::vector<int> placement(unsigned threads) const;
+
+    std::string describe() const; // "2 nodes: 0[0-15] 1[16-31]"
+};
+
+// Parse a sysfs CPU list such as "0-3,8,10-11"
+std::vector<int> parseCpuList(const std::string &list);
+
+// Restrict the calling thread to `cpu`; false if the OS refused (or has no
+// affinity API)
+bool pinCurrentThread(int cpu);
+
+// Pins the calling thread to one CPU for its lifetime and then restores the
+// affinity mask it had before
+class ScopedCpuPin {
+public:
+    explicit ScopedCpuPin(int cpu);
+    ~ScopedCpuPin();
+    ScopedCpuPin(const ScopedCpuPin &) = delete;
+    ScopedCpuPin &operator=(const ScopedCpuPin &) = delete;
+
+private:
+    std::vector<int> previous_; // CPUs of the old mask; empty = nothing to restore
+};
+
+// Copy of `src` (same logical rows, identity permutation) in a buffer that is
+// never written by the calling thread: each pool thread first touches exactly
+// the physical rows gaussJordanParallel() assigns to it on the same pool
+// (splitRange over n rows), so with a pinned pool the pages of every row
+// block are placed on the owning worker's node. Row swaps only permute the
+// index, so the rows stay local for the whole solve.
+Matrix copyFirstTouch(const Matrix &src, ThreadPool &pool);
+
+#endif // SRC_NUMA_H
@@ -0,0 +1,380 @@
+#include "src_out_of_core.h"
+#include "src_matrix_io.h"
+#include "src_row_kernels.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <future>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#define GJ_HAVE_PREAD 1
+#endif
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double msSince(Clock::time_point t0) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+}
+
+#if defined(GJ_HAVE_PREAD)
+
+// File descriptor with positioned, retrying reads and writes; safe to use
+// from the prefetch thread and the compute thread at the same time
+class File {
+public:
+    File(const std::string &path, int flags) : path_(path), fd_(open(path.c_str(), flags, 0644)) {
+        if (fd_ < 0) throw std::runtime_error("Cannot open " + path);
+    }
+    ~File() { close(fd_); }
+    File(const File &) = delete;
+    File &operator=(const File &) = delete;
+
+    void readAt(void *dst, size_t bytes, uint64_t offset) const {
+        char *p = static_cast<char *>(dst);
+        while (bytes > 0) {
+            ssize_t got = pread(fd_, p, bytes, static_cast<off_t>(offset));
+            if (got < 0 && errno == EINTR) continue;
+            if (got <= 0) throw std::runtime_error("Read failed: " + path_);
+            p += got;
+            bytes -= static_cast<size_t>(got);
+            offset += static_cast<uint64_t>(got);
+        }
+    }
+
+    void writeAt(const void *src, size_t bytes, uint64_t offset) const {
+        const char *p = static_cast<const char *>(src);
+        while (bytes > 0) {
+            ssize_t put = pwrite(fd_, p, bytes, static_cast<off_t>(offset));
+            if (put < 0 && errno == EINTR) continue;
+            if (put <= 0) throw std::runtime_error("Write failed: " + path_);
+            p += put;
+            bytes -= static_cast<size_t>(put);
+            offset += static_cast<uint64_t>(put);
+        }
+    }
+
+private:
+    std::string path_;
+    int fd_;
+};
+
+// Columns [first, first + width) of [A|B], stored as n rows of `width`
+// doubles starting at byte `offset` of the scratch file
+struct Panel {
+    int first;
+    int width;
+    uint64_t offset;
+};
+
+class PanelFile {
+public:
+    PanelFile(const std::string &path, int n, int rhs, int width) : file_(path, O_RDWR | O_CREAT | O_TRUNC), n_(n) {
+        uint64_t offset = 0;
+        auto cut = [&](int from, int to) {
+            for (int c = from; c < to; c += width) {
+                Panel p{c, std::min(width, to - c), offset};
+                offset += static_cast<uint64_t>(n) * p.width * sizeof(double);
+                panels_.push_back(p);
+            }
+        };
+        cut(0, n);
+        factorPanels_ = static_cast<int>(panels_.size());
+        cut(n, n + rhs); // right-hand sides never share a panel with A
+    }
+
+    int count() const { return static_cast<int>(panels_.size()); }
+    // Panels [0, factorPanels()) hold A, the rest B
+    int factorPanels() const { return factorPanels_; }
+    const Panel &panel(int p) const { return panels_[p]; }
+
+    void read(int p, double *dst) {
+        size_t bytes = static_cast<size_t>(n_) * panels_[p].width * sizeof(double);
+        file_.readAt(dst, bytes, panels_[p].offset);
+        bytesRead += bytes;
+    }
+
+    void write(int p, const double *src) {
+        size_t bytes = static_cast<size_t>(n_) * panels_[p].width * sizeof(double);
+        file_.writeAt(src, bytes, panels_[p].offset);
+        bytesWritten += bytes;
+    }
+
+    // Rows [r0, r1) of panel p, `src` holding them back to back
+    void writeRows(int p, int r0, int r1, const double *src) {
+        size_t bytes = static_cast<size_t>(r1 - r0) * panels_[p].width * sizeof(double);
+        file_.writeAt(src, bytes, panels_[p].offset + static_cast<uint64_t>(r0) * panels_[p].width * sizeof(double));
+        bytesWritten += bytes;
+    }
+
+    size_t bytesRead = 0; // only touched by one read at a time (see PanelPrefetcher)
+    size_t bytesWritten = 0;
+
+private:
+    File file_;
+    int n_;
+    int factorPanels_ = 0;
+    std::vector<Panel> panels_;
+};
+
+// Two panel buffers: while the caller works on one, the next panel of the
+// sequence is read into the other on a background thread
+class PanelPrefetcher {
+public:
+    PanelPrefetcher(PanelFile &file, size_t panelElements) : file_(file) {
+        for (std::vector<double> &b : buffers_) b.resize(panelElements);
+    }
+    ~PanelPrefetcher() {
+        if (pending_.valid()) pending_.wait();
+    }
+
+    // Buffer holding panel p, which the caller may modify until the next
+    // call; starts reading panel `next` (-1: none) into the other buffer
+    double *fetch(int p, int next) {
+        auto t0 = Clock::now();
+        if (pending_.valid()) pending_.get(); // rethrows a failed read
+        int slot = held_[0] == p ? 0 : held_[1] == p ? 1 : -1;
+        if (slot < 0) {
+            slot = 0;
+            file_.read(p, buffers_[slot].data());
+        }
+        waitMs += msSince(t0);
+        held_[slot] = -1; // contents may change from here on
+        if (next >= 0) {
+            int other = 1 - slot;
+            held_[other] = next;
+            pending_ = std::async(std::launch::async, [this, other, next] {
+                file_.read(next, buffers_[other].data());
+            });
+        }
+        return buffers_[slot].data();
+    }
+
+    double waitMs = 0.0;
+
+private:
+    PanelFile &file_;
+    std::vector<double> buffers_[2];
+    int held_[2] = {-1, -1};
+    std::future<void> pending_;
+};
+
+// Row-major system file -> panel layout, `rowsPerBlock` rows at a time
+void copyToPanels(const File &system, const MatrixFileHeader &h, PanelFile &panels, int rowsPerBlock,
+                  size_t &bytesRead) {
+    int n = static_cast<int>(h.rows);
+    std::vector<double> rows(static_cast<size_t>(rowsPerBlock) * h.stride);
+    std::vector<double> staging;
+    for (int r0 = 0; r0 < n; r0 += rowsPerBlock) {
+        int r1 = std::min(n, r0 + rowsPerBlock);
+        size_t bytes = static_cast<size_t>(r1 - r0) * h.stride * sizeof(double);
+        system.readAt(rows.data(), bytes, h.dataOffset + static_cast<uint64_t>(r0) * h.stride * sizeof(double));
+        bytesRead += bytes;
+        for (int p = 0; p < panels.count(); ++p) {
+            const Panel &pan = panels.panel(p);
+            staging.resize(static_cast<size_t>(r1 - r0) * pan.width);
+            for (int r = r0; r < r1; ++r) {
+                const double *src = rows.data() + static_cast<size_t>(r - r0) * h.stride + pan.first;
+                std::copy(src, src + pan.width, staging.data() + static_cast<size_t>(r - r0) * pan.width);
+            }
+            panels.writeRows(p, r0, r1, staging.data());
+        }
+    }
+}
+
+void swapPanelRows(double *panel, int width, int a, int b) {
+    std::swap_ranges(panel + static_cast<size_t>(a) * width, panel + static_cast<size_t>(a + 1) * width,
+                     panel + static_cast<size_t>(b) * width);
+}
+
+#endif // GJ_HAVE_PREAD
+
+} // namespace
+
+int outOfCorePanelWidth(int n, int rhs, size_t memoryBudget) {
+    (void)rhs; // right-hand-side panels are cut to the same width
+    size_t perColumn = 3 * static_cast<size_t>(std::max(n, 1)) * sizeof(double);
+    size_t width = memoryBudget / perColumn / 8 * 8;
+    if (width < 8) {
+        throw std::runtime_error("Memory budget too small: need at least " + std::to_string(perColumn * 8) +
+                                 " bytes for 8-column panels.");
+    }
+    return static_cast<int>(std::min<size_t>(width, static_cast<size_t>(std::max(n, 8) + 7) / 8 * 8));
+}
+
+std::vector<double> solveOutOfCore(const std::string &systemPath, const OutOfCoreOptions &options,
+                                   OutOfCoreStats *stats) {
+#if defined(GJ_HAVE_PREAD)
+    MatrixFileHeader h = readMatrixHeader(systemPath);
+    const int n = static_cast<int>(h.rows);
+    const int rhs = static_cast<int>(h.rhs);
+    OutOfCoreStats st;
+    st.n = n;
+    st.rhs = rhs;
+    std::vector<double> x(static_cast<size_t>(n) * rhs);
+    if (n == 0) {
+        if (stats) *stats = st;
+        return x;
+    }
+
+    const int w = outOfCorePanelWidth(n, rhs, options.memoryBudget);
+    const std::string scratch = options.scratchPath.empty() ? systemPath + ".panels" : options.scratchPath;
+    RowUpdateFn update = rowUpdateKernel(options.kernel);
+
+    struct ScratchGuard {
+        const std::string &path;
+        bool remove;
+        ~ScratchGuard() {
+            if (remove) std::remove(path.c_str());
+        }
+    };
+    PanelFile panels(scratch, n, rhs, w);
+    ScratchGuard guard{scratch, options.removeScratch};
+    st.panelWidth = w;
+    st.panels = panels.count();
+
+    auto t0 = Clock::now();
+    {
+        File system(systemPath, O_RDONLY);
+        size_t rowBytes = static_cast<size_t>(h.stride) * sizeof(double);
+        int rowsPerBlock = static_cast<int>(std::max<size_t>(1, options.memoryBudget / 2 / rowBytes));
+        copyToPanels(system, h, panels, std::min(rowsPerBlock, n), st.bytesRead);
+    }
+    st.copyMs = msSince(t0);
+
+    // Every panel read of the solve, in order, so the prefetcher always knows
+    // the next one: panel J, then panels 0..J-1 for its update; finally the A
+    // panels right to left for back substitution
+    const int nA = panels.factorPanels();
+    std::vector<int> order;
+    for (int J = 0; J < panels.count(); ++J) {
+        order.push_back(J);
+        for (int I = 0; I < std::min(J, nA); ++I) order.push_back(I);
+    }
+    for (int J = nA - 1; J >= 0; --J) order.push_back(J);
+    size_t step = 0;
+    PanelPrefetcher prefetcher(panels, static_cast<size_t>(n) * w);
+    auto fetchNext = [&]() {
+        int p = order[step++];
+        return prefetcher.fetch(p, step < order.size() ? order[step] : -1);
+    };
+
+    std::vector<int> piv(n);
+    std::vector<double> cur(static_cast<size_t>(n) * w);
+    auto t1 = Clock::now();
+    for (int J = 0; J < panels.count(); ++J) {
+        const Panel &pj = panels.panel(J);
+        const int wj = pj.width;
+        const bool factor = J < nA;
+        const int j0 = factor ? pj.first : n; // pivots already chosen: rows [0, j0)
+        const double *loaded = fetchNext();
+        std::copy(loaded, loaded + static_cast<size_t>(n) * wj, cur.data());
+        for (int k = 0; k < j0; ++k) {
+            if (piv[k] != k) swapPanelRows(cur.data(), wj, k, piv[k]);
+        }
+
+        // Left-looking update with each factored panel I: rows of I's diagonal
+        // block by forward substitution with the unit L_II, rows below by
+        // subtracting L(rows, I) times the rows just solved
+        for (int I = 0; I < std::min(J, nA); ++I) {
+            const Panel &pi = panels.panel(I);
+            const int wi = pi.width, i0 = pi.first, i1 = pi.first + pi.width;
+            double *L = fetchNext();
+            // Stored before the pivots of later panels were known
+            for (int k = i1; k < j0; ++k) {
+                if (piv[k] != k) swapPanelRows(L, wi, k, piv[k]);
+            }
+            for (int r = i0; r < n; ++r) {
+                const double *lr = L + static_cast<size_t>(r) * wi;
+                double *cr = cur.data() + static_cast<size_t>(r) * wj;
+                int kEnd = std::min(r, i1);
+                for (int k = i0; k < kEnd; ++k) {
+                    double l = lr[k - i0];
+                    if (l != 0.0) update(cr, cur.data() + static_cast<size_t>(k) * wj, wj, l);
+                }
+            }
+        }
+
+        if (!factor) {
+            // Y = L^-1 P B: keep it for the back substitution
+            for (int r = 0; r < n; ++r) {
+                std::copy(cur.data() + static_cast<size_t>(r) * wj, cur.data() + static_cast<size_t>(r + 1) * wj,
+                          x.data() + static_cast<size_t>(r) * rhs + (pj.first - n));
+            }
+            continue;
+        }
+
+        // Unblocked LU with partial pivoting of the panel's trailing rows
+        for (int k = j0; k < j0 + wj; ++k) {
+            int c = k - j0;
+            int pivot_row = k;
+            double maxval = std::abs(cur[static_cast<size_t>(k) * wj + c]);
+            for (int r = k + 1; r < n; ++r) {
+                double v = std::abs(cur[static_cast<size_t>(r) * wj + c]);
+                if (v > maxval) {
+                    maxval = v;
+                    pivot_row = r;
+                }
+            }
+            if (maxval < 1e-15) {
+                throw std::runtime_error("Matrix is singular or nearly singular (pivot ~ 0).");
+            }
+            piv[k] = pivot_row;
+            if (pivot_row != k) swapPanelRows(cur.data(), wj, k, pivot_row);
+
+            const double *rk = cur.data() + static_cast<size_t>(k) * wj;
+            double inv_pivot = 1.0 / rk[c];
+            for (int r = k + 1; r < n; ++r) {
+                double *rr = cur.data() + static_cast<size_t>(r) * wj;
+                double l = rr[c] * inv_pivot;
+                rr[c] = l;
+                if (l != 0.0 && c + 1 < wj) update(rr + c + 1, rk + c + 1, wj - c - 1, l);
+            }
+        }
+        panels.write(J, cur.data());
+    }
+    st.factorMs = msSince(t1);
+
+    // U X = Y, one column panel of U at a time from the right
+    auto t2 = Clock::now();
+    for (int J = nA - 1; J >= 0; --J) {
+        const Panel &pj = panels.panel(J);
+        const int wj = pj.width, j0 = pj.first;
+        const double *U = fetchNext();
+        for (int i = j0 + wj - 1; i >= j0; --i) {
+            const double *ui = U + static_cast<size_t>(i) * wj;
+            double *xi = x.data() + static_cast<size_t>(i) * rhs;
+            for (int c = i - j0 + 1; c < wj; ++c) {
+                if (ui[c] != 0.0) update(xi, x.data() + static_cast<size_t>(j0 + c) * rhs, rhs, ui[c]);
+            }
+            double inv = 1.0 / ui[i - j0];
+            for (int c = 0; c < rhs; ++c) xi[c] *= inv;
+        }
+        for (int r = 0; r < j0; ++r) {
+            const double *ur = U + static_cast<size_t>(r) * wj;
+            double *xr = x.data() + static_cast<size_t>(r) * rhs;
+            for (int c = 0; c < wj; ++c) {
+                if (ur[c] != 0.0) update(xr, x.data() + static_cast<size_t>(j0 + c) * rhs, rhs, ur[c]);
+            }
+        }
+    }
+    st.solveMs = msSince(t2);
+
+    st.ioWaitMs = prefetcher.waitMs;
+    st.bytesRead += panels.bytesRead;
+    st.bytesWritten = panels.bytesWritten;
+    if (stats) *stats = st;
+    return x;
+#else
+    (void)systemPath;
+    (void)options;
+    (void)stats;
+    throw std::runtime_error("Out-of-core solve needs POSIX pread/pwrite.");
+#endif
+}
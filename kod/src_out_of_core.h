@@ -0,0 +1,59 @@
+#ifndef SRC_OUT_OF_CORE_H
+#define SRC_OUT_OF_CORE_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "src_row_kernels.h"
+
+// Out-of-core solve of a system [A|B] stored in a file (format of
+// src_matrix_io.h) for n too large for Matrix to hold in memory.
+//
+// The columns of [A|B] are cut into panels whose width follows from the
+// memory budget. The system file is copied once into a scratch file that keeps
+// every panel contiguous (n rows x panel width, row-major), then the panels
+// are factored left to right (left-looking blocked LU with partial pivoting):
+// panel J is brought up to date with the L factors of panels 0..J-1, streamed
+// from the scratch file one at a time, then factored in memory and written
+// back. The right-hand-side columns are panels that only receive the updates,
+// which leaves Y = L^-1 P B in them; back substitution then streams the U
+// panels right to left. A background read fetches the next panel of the
+// sequence while the current one is being used.
+struct OutOfCoreOptions {
+    // Bytes for panel buffers: three panels (the one being factored, the one
+    // streamed and the one being prefetched). Must fit at least 8 columns.
+    // X and the pivot vector come on top; the initial copy into the scratch
+    // file runs in row blocks within the same budget.
+    size_t memoryBudget = size_t(1) << 30;
+    // Scratch file for the panels; empty = "<system file>.panels"
+    std::string scratchPath;
+    // Delete the scratch file when the solve ends
+    bool removeScratch = true;
+    // Row update used by the panel updates and the substitution
+    RowKernel kernel = RowKernel::Cpp;
+};
+
+struct OutOfCoreStats {
+    int n = 0;
+    int rhs = 0;
+    int panelWidth = 0;
+    int panels = 0;          // A panels + right-hand-side panels
+    size_t bytesRead = 0;    // scratch and system file reads
+    size_t bytesWritten = 0; // scratch file writes
+    double copyMs = 0.0;     // system file -> panel layout
+    double factorMs = 0.0;   // factorization and forward elimination
+    double solveMs = 0.0;    // back substitution
+    double ioWaitMs = 0.0;   // time compute waited for a panel read
+};
+
+// Panel width for an n x (n + rhs) system and a budget; throws
+// std::runtime_error when fewer than 8 columns fit
+int outOfCorePanelWidth(int n, int rhs, size_t memoryBudget);
+
+// Solve the system stored at `systemPath` and return X (n x rhs, row-major).
+// The system file is only read. Throws std::runtime_error for I/O errors, a
+// too small budget or a singular A.
+std::vector<double> solveOutOfCore(const std::string &systemPath, const OutOfCoreOptions &options = {},
+                                   OutOfCoreStats *stats = nullptr);
+
+#endif // SRC_OUT_OF_CORE_H
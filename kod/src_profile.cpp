@@ -0,0 +1,139 @@
+#include "src_profile.h"
+#include <sstream>
+
+#if defined(GJ_ENABLE_PROFILING) && defined(__linux__)
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+const char *solvePhaseName(SolvePhase phase) {
+    switch (phase) {
+    case SolvePhase::PivotSearch: return "pivot_search";
+    case SolvePhase::RowSwap: return "row_swap";
+    case SolvePhase::PivotScale: return "pivot_scale";
+    case SolvePhase::Elimination: return "elimination";
+    case SolvePhase::Sync: return "sync";
+    }
+    return "?";
+}
+
+#if defined(GJ_ENABLE_PROFILING)
+
+#if defined(__linux__)
+namespace {
+
+// Counter for the calling thread only, on any CPU; -1 when not permitted
+int openCounter(uint32_t type, uint64_t config, int groupFd) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = groupFd == -1 ? 1 : 0; // the group starts with its leader
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, groupFd, 0));
+}
+
+} // namespace
+#endif
+
+void ThreadRecorder::start() {
+    if (!active_) return;
+#if defined(__linux__)
+    counterFd_ = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, -1);
+    if (counterFd_ >= 0) {
+        memberFds_[0] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, counterFd_);
+        memberFds_[1] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES, counterFd_);
+        ioctl(counterFd_, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(counterFd_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+#endif
+    last_ = std::chrono::steady_clock::now();
+}
+
+void ThreadRecorder::stop(ThreadProfile *out) {
+    if (!active_) return;
+#if defined(__linux__)
+    if (counterFd_ >= 0) {
+        ioctl(counterFd_, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+        uint64_t values[4] = {}; // nr, cycles, instructions, misses
+        ssize_t got = read(counterFd_, values, sizeof(values));
+        if (got >= static_cast<ssize_t>(2 * sizeof(uint64_t))) {
+            profile_.countersValid = memberFds_[0] >= 0 && memberFds_[1] >= 0;
+            profile_.cycles = values[1];
+            profile_.instructions = memberFds_[0] >= 0 ? values[2] : 0;
+            profile_.llcMisses = memberFds_[1] >= 0 ? values[memberFds_[0] >= 0 ? 3 : 2] : 0;
+        }
+    }
+#endif
+    for (int p = 0; p < kSolvePhaseCount; ++p) {
+        if (p == static_cast<int>(SolvePhase::Sync)) profile_.idleMs += profile_.phaseMs[p];
+        else profile_.busyMs += profile_.phaseMs[p];
+    }
+    if (out) *out = profile_;
+}
+
+ThreadRecorder::~ThreadRecorder() {
+#if defined(__linux__)
+    for (int fd : memberFds_) {
+        if (fd >= 0) close(fd);
+    }
+    if (counterFd_ >= 0) close(counterFd_);
+#endif
+}
+
+#endif // GJ_ENABLE_PROFILING
+
+void finishProfile(SolveProfile *profile, std::vector<ThreadProfile> &threads, double totalMs) {
+    if (!profile) return;
+    *profile = SolveProfile();
+#if defined(GJ_ENABLE_PROFILING)
+    profile->enabled = true;
+    profile->totalMs = totalMs;
+    profile->countersAvailable = !threads.empty();
+    for (const ThreadProfile &t : threads) {
+        for (int p = 0; p < kSolvePhaseCount; ++p) profile->phaseMs[p] += t.phaseMs[p];
+        profile->countersAvailable = profile->countersAvailable && t.countersValid;
+        profile->cycles += t.cycles;
+        profile->instructions += t.instructions;
+        profile->llcMisses += t.llcMisses;
+    }
+    profile->threads.swap(threads);
+#else
+    (void)threads;
+    (void)totalMs;
+#endif
+}
+
+std::string SolveProfile::toJson() const {
+    std::ostringstream out;
+    out.precision(6);
+    out << "{\"enabled\": " << (enabled ? "true" : "false") << ", \"total_ms\": " << totalMs << ", \"phases_ms\": {";
+    for (int p = 0; p < kSolvePhaseCount; ++p) {
+        out << (p ? ", " : "") << '"' << solvePhaseName(static_cast<SolvePhase>(p)) << "\": " << phaseMs[p];
+    }
+    out << "}, \"counters\": ";
+    if (countersAvailable) {
+        out << "{\"cycles\": " << cycles << ", \"instructions\": " << instructions << ", \"llc_misses\": " << llcMisses
+            << "}";
+    } else {
+        out << "null";
+    }
+    out << ", \"threads\": [";
+    for (size_t t = 0; t < threads.size(); ++t) {
+        const ThreadProfile &tp = threads[t];
+        out << (t ? ", " : "") << "{\"busy_ms\": " << tp.busyMs << ", \"idle_ms\": " << tp.idleMs;
+        if (tp.countersValid) {
+            out << ", \"cycles\": " << tp.cycles << ", \"instructions\": " << tp.instructions
+                << ", \"llc_misses\": " << tp.llcMisses;
+        }
+        out << "}";
+    }
+    out << "]}";
+    return out.str();
+}
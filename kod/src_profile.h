@@ -0,0 +1,85 @@
+#ifndef SRC_PROFILE_H
+#define SRC_PROFILE_H
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Opt-in instrumentation of the Gauss-Jordan solvers.
+//
+// Pass a SolveProfile to gaussJordanSequential/gaussJordanParallel to get the
+// time spent per phase and per thread, plus hardware counters (cycles,
+// instructions, last-level-cache misses) read through perf_event_open when
+// the kernel allows it. Recording only exists in builds configured with
+// -DGJ_ENABLE_PROFILING=ON; otherwise the recorder below is empty, the solvers
+// compile to the same code as before and a profile comes back with
+// enabled == false.
+
+enum class SolvePhase { PivotSearch, RowSwap, PivotScale, Elimination, Sync };
+constexpr int kSolvePhaseCount = 5;
+
+const char *solvePhaseName(SolvePhase phase);
+
+struct ThreadProfile {
+    std::array<double, kSolvePhaseCount> phaseMs{};
+    double busyMs = 0.0; // every phase except Sync
+    double idleMs = 0.0; // waiting for other threads (Sync)
+    bool countersValid = false;
+    uint64_t cycles = 0;
+    uint64_t instructions = 0;
+    uint64_t llcMisses = 0;
+};
+
+struct SolveProfile {
+    bool enabled = false;           // false in builds without GJ_ENABLE_PROFILING
+    bool countersAvailable = false; // every thread got its hardware counters
+    double totalMs = 0.0;           // wall time of the solve
+    std::array<double, kSolvePhaseCount> phaseMs{}; // summed over threads
+    std::vector<ThreadProfile> threads;
+    uint64_t cycles = 0; // summed over threads, valid if countersAvailable
+    uint64_t instructions = 0;
+    uint64_t llcMisses = 0;
+
+    std::string toJson() const;
+};
+
+// Records one thread's share of a SolveProfile: mark(phase) charges the time
+// since the previous mark (or start()) to `phase`. An inactive recorder, or any
+// recorder in a build without GJ_ENABLE_PROFILING, does nothing.
+class ThreadRecorder {
+public:
+#if defined(GJ_ENABLE_PROFILING)
+    explicit ThreadRecorder(bool active) : active_(active) {}
+    ~ThreadRecorder();
+    ThreadRecorder(const ThreadRecorder &) = delete;
+    ThreadRecorder &operator=(const ThreadRecorder &) = delete;
+
+    void start();
+    void mark(SolvePhase phase) {
+        if (!active_) return;
+        auto now = std::chrono::steady_clock::now();
+        profile_.phaseMs[static_cast<int>(phase)] += std::chrono::duration<double, std::milli>(now - last_).count();
+        last_ = now;
+    }
+    void stop(ThreadProfile *out);
+
+private:
+    bool active_;
+    int counterFd_ = -1; // perf event group leader (cycles)
+    int memberFds_[2] = {-1, -1};
+    std::chrono::steady_clock::time_point last_;
+    ThreadProfile profile_;
+#else
+    explicit ThreadRecorder(bool) {}
+    void start() {}
+    void mark(SolvePhase) {}
+    void stop(ThreadProfile *) {}
+#endif
+};
+
+// Sum the per-thread records into `profile` (no-op for a null profile)
+void finishProfile(SolveProfile *profile, std::vector<ThreadProfile> &threads, double totalMs);
+
+#endif // SRC_PROFILE_H
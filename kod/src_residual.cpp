@@ -0,0 +1,143 @@
+#include "src_gauss_jordan.h"
+#include "src_thread_pool.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// Built with -ffp-contract=off (see CMakeLists.txt): a multiply-add fused by
+// the compiler would break the error-free transformations below.
+
+namespace {
+
+// Below this many multiply-adds the residual is not worth a pool round trip
+constexpr double kParallelResidualWork = 1 << 18;
+
+#if defined(__GNUC__)
+// Two doubles: one SSE2/NEON register in the baseline ABI, so the helpers
+// below can pass Lanes by value without depending on -mavx
+typedef double Lanes __attribute__((vector_size(2 * sizeof(double))));
+
+inline Lanes loadLanes(const double *p) {
+    Lanes v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+#endif
+
+// sum_j a[j] * b[j] - bias, two vector accumulators
+double dotPlain(const double *a, const double *b, int n, double bias) {
+    double s = -bias;
+    int j = 0;
+#if defined(__GNUC__)
+    Lanes acc0 = {}, acc1 = {};
+    for (; j + 4 <= n; j += 4) {
+        acc0 += loadLanes(a + j) * loadLanes(b + j);
+        acc1 += loadLanes(a + j + 2) * loadLanes(b + j + 2);
+    }
+    Lanes acc = acc0 + acc1;
+    s += acc[0] + acc[1];
+#endif
+    for (; j < n; ++j) s += a[j] * b[j];
+    return s;
+}
+
+// Error-free transformations (Knuth's TwoSum, Dekker's TwoProduct): x + y = s + e
+// and x * y = p + e exactly. Written with + - * only, so they work on Lanes too.
+template <typename V>
+inline void twoSum(V x, V y, V &s, V &e) {
+    s = x + y;
+    V z = s - x;
+    e = (x - (s - z)) + (y - z);
+}
+
+template <typename V>
+inline void twoProduct(V x, V y, V &p, V &e) {
+    const double split = 134217729.0; // 2^27 + 1
+    V cx = x * split, cy = y * split;
+    V xh = cx - (cx - x), yh = cy - (cy - y);
+    V xl = x - xh, yl = y - yh;
+    p = x * y;
+    e = ((xh * yh - p) + xh * yl + xl * yh) + xl * yl;
+}
+
+// Dot2 of Ogita, Rump and Oishi: sum_j a[j] * b[j] - bias as if computed in
+// twice the working precision, then rounded once
+double dotCompensated(const double *a, const double *b, int n, double bias) {
+    double s = -bias, c = 0.0;
+    int j = 0;
+#if defined(__GNUC__)
+    Lanes vs = {}, vc = {};
+    for (; j + 2 <= n; j += 2) {
+        Lanes p, ep, es;
+        twoProduct(loadLanes(a + j), loadLanes(b + j), p, ep);
+        twoSum(vs, p, vs, es);
+        vc += ep + es;
+    }
+    for (int l = 0; l < 2; ++l) {
+        double e;
+        twoSum(s, vs[l], s, e);
+        c += e + vc[l];
+    }
+#endif
+    for (; j < n; ++j) {
+        double p, ep, es;
+        twoProduct(a[j], b[j], p, ep);
+        twoSum(s, p, s, es);
+        c += ep + es;
+    }
+    return s + c;
+}
+
+} // namespace
+
+double residualNorm(const Matrix &orig, const Matrix &reduced, Summation summation) {
+    if (orig.n != reduced.n || orig.rhs != reduced.rhs) return -1.0;
+    std::vector<double> r;
+    return residualBlock(orig, reduced.solutionBlock(), r, summation);
+}
+
+double residualBlock(const Matrix &orig, const std::vector<double> &x, std::vector<double> &r, Summation summation,
+                     unsigned threadCount) {
+    const int n = orig.n;
+    const int m = orig.rhs;
+    r.assign(static_cast<size_t>(n) * m, 0.0);
+    if (n == 0 || m == 0) return 0.0;
+
+    // Columns of X, so every residual entry is one contiguous dot product
+    std::vector<double> xt(static_cast<size_t>(m) * n);
+    for (int j = 0; j < n; ++j) {
+        for (int c = 0; c < m; ++c) xt[static_cast<size_t>(c) * n + j] = x[static_cast<size_t>(j) * m + c];
+    }
+    auto dot = summation == Summation::Compensated ? dotCompensated : dotPlain;
+
+    if (threadCount == 0) {
+        unsigned hw = std::thread::hardware_concurrency();
+        threadCount = hw > 0 ? hw : 1;
+    }
+    if (static_cast<double>(n) * n * m < kParallelResidualWork) threadCount = 1;
+    threadCount = std::min(threadCount, static_cast<unsigned>(n));
+
+    // One partial sum of squares per thread, added in thread order: the same
+    // thread count always gives the same result
+    std::vector<double> partial(threadCount, 0.0);
+    auto rowsOf = [&](unsigned tid) {
+        int begin, end;
+        splitRange(n, threadCount, tid, begin, end);
+        double sumsq = 0.0;
+        for (int i = begin; i < end; ++i) {
+            const double *a = orig.row(i);
+            double *ri = r.data() + static_cast<size_t>(i) * m;
+            for (int c = 0; c < m; ++c) {
+                ri[c] = -dot(a, xt.data() + static_cast<size_t>(c) * n, n, a[n + c]);
+                sumsq += ri[c] * ri[c];
+            }
+        }
+        partial[tid] = sumsq;
+    };
+    if (threadCount == 1) rowsOf(0);
+    else ThreadPool::shared(threadCount).run(rowsOf);
+
+    double sumsq = 0.0;
+    for (double p : partial) sumsq += p;
+    return std::sqrt(sumsq);
+}
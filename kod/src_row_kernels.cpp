@@ -0,0 +1,131 @@
+#include "src_row_kernels.h"
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#if defined(GJ_HAVE_X86_ASM)
+#include <cpuid.h>
+
+extern "C" {
+void gj_row_update_sse2(double *dst, const double *src, std::size_t count, double factor);
+void gj_row_update_avx2(double *dst, const double *src, std::size_t count, double factor);
+void gj_row_update_avx512(double *dst, const double *src, std::size_t count, double factor);
+}
+#endif
+
+static void row_update_cpp(double *dst, const double *src, std::size_t count, double factor) {
+    for (std::size_t j = 0; j < count; ++j) dst[j] -= factor * src[j];
+}
+
+#if defined(GJ_HAVE_X86_ASM)
+struct CpuFeatures {
+    bool sse2 = false;
+    bool avx2_fma = false;
+    bool avx512f = false;
+};
+
+static unsigned long long read_xcr0() {
+    unsigned eax, edx;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (static_cast<unsigned long long>(edx) << 32) | eax;
+}
+
+// CPUID says what the core implements; XCR0 says which register state the
+// OS saves on context switch. A vector width is usable only if both agree.
+static CpuFeatures detect_features() {
+    CpuFeatures f;
+    unsigned eax, ebx, ecx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) return f;
+    f.sse2 = (edx & bit_SSE2) != 0;
+
+    bool osxsave = (ecx & bit_OSXSAVE) != 0;
+    bool fma = (ecx & bit_FMA) != 0;
+    bool avx = (ecx & bit_AVX) != 0;
+    if (!osxsave || !avx) return f;
+
+    unsigned long long xcr0 = read_xcr0();
+    bool ymm_state = (xcr0 & 0x6) == 0x6;    // SSE + AVX state
+    bool zmm_state = (xcr0 & 0xe6) == 0xe6;  // + opmask, ZMM_Hi256, Hi16_ZMM
+
+    if (__get_cpuid_max(0, nullptr) < 7) return f;
+    __cpuid_count(7, 0, eax, ebx, ecx, edx);
+    f.avx2_fma = ymm_state && fma && (ebx & bit_AVX2) != 0;
+    f.avx512f = zmm_state && (ebx & bit_AVX512F) != 0;
+    return f;
+}
+
+static const CpuFeatures &features() {
+    static const CpuFeatures f = detect_features();
+    return f;
+}
+#endif
+
+bool rowKernelSupported(RowKernel kernel) {
+    switch (kernel) {
+    case RowKernel::Cpp:
+    case RowKernel::Auto:
+        return true;
+#if defined(GJ_HAVE_X86_ASM)
+    case RowKernel::SSE2:
+        return features().sse2;
+    case RowKernel::AVX2:
+        return features().avx2_fma;
+    case RowKernel::AVX512:
+        return features().avx512f;
+#else
+    default:
+        return false;
+#endif
+    }
+    return false;
+}
+
+RowKernel bestRowKernel() {
+    if (rowKernelSupported(RowKernel::AVX512)) return RowKernel::AVX512;
+    if (rowKernelSupported(RowKernel::AVX2)) return RowKernel::AVX2;
+    if (rowKernelSupported(RowKernel::SSE2)) return RowKernel::SSE2;
+    return RowKernel::Cpp;
+}
+
+RowUpdateFn rowUpdateKernel(RowKernel kernel) {
+    if (kernel == RowKernel::Auto) kernel = bestRowKernel();
+    if (!rowKernelSupported(kernel)) {
+        throw std::runtime_error(std::string("Row kernel not supported on this machine: ") +
+                                 rowKernelName(kernel));
+    }
+    switch (kernel) {
+#if defined(GJ_HAVE_X86_ASM)
+    case RowKernel::SSE2:
+        return gj_row_update_sse2;
+    case RowKernel::AVX2:
+        return gj_row_update_avx2;
+    case RowKernel::AVX512:
+        return gj_row_update_avx512;
+#endif
+    default:
+        return row_update_cpp;
+    }
+}
+
+const char *rowKernelName(RowKernel kernel) {
+    switch (kernel) {
+    case RowKernel::Cpp: return "cpp";
+    case RowKernel::SSE2: return "sse2";
+    case RowKernel::AVX2: return "avx2";
+    case RowKernel::AVX512: return "avx512";
+    case RowKernel::Auto: return "auto";
+    }
+    return "?";
+}
+
+bool parseRowKernel(const char *name, RowKernel &kernel) {
+    const RowKernel all[] = {RowKernel::Cpp, RowKernel::SSE2, RowKernel::AVX2, RowKernel::AVX512,
+                             RowKernel::Auto};
+    for (RowKernel k : all) {
+        if (std::strcmp(name, rowKernelName(k)) == 0) {
+            kernel = k;
+            return true;
+        }
+    }
+    return false;
+}
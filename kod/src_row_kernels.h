@@ -0,0 +1,30 @@
+#ifndef SRC_ROW_KERNELS_H
+#define SRC_ROW_KERNELS_H
+
+#include <cstddef>
+
+// Implementations of the elimination hot spot  row_i -= factor * row_k
+// Cpp is the portable C++ loop; the others are the hand-written x86-64
+// kernels from src_gauss_jordan_asm.s. Auto picks the widest one the CPU
+// (and OS) supports, decided once via CPUID.
+enum class RowKernel { Cpp, SSE2, AVX2, AVX512, Auto };
+
+// dst[j] -= factor * src[j] for j in [0, count)
+using RowUpdateFn = void (*)(double *dst, const double *src, std::size_t count, double factor);
+
+// Resolve a kernel to its function; throws std::runtime_error if the CPU
+// or the build does not support it.
+RowUpdateFn rowUpdateKernel(RowKernel kernel);
+
+// True when `kernel` can run on this machine (Cpp and Auto always can)
+bool rowKernelSupported(RowKernel kernel);
+
+// Widest supported kernel (what Auto resolves to)
+RowKernel bestRowKernel();
+
+const char *rowKernelName(RowKernel kernel);
+
+// Parse "cpp", "sse2", "avx2", "avx512" or "auto"; returns false on unknown names
+bool parseRowKernel(const char *name, RowKernel &kernel);
+
+#endif // SRC_ROW_KERNELS_H
@@ -0,0 +1,193 @@
+#include "src_solve_service.h"
+#include "src_batched.h"
+#include "src_stats.h"
+#include "src_thread_pool.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+} // namespace
+
+SolveService::SolveService(const SolveServiceOptions &options) : options_(options) {
+    if (options_.threads == 0) {
+        unsigned hw = std::thread::hardware_concurrency();
+        options_.threads = hw > 0 ? hw : 1;
+    }
+    options_.maxBatch = std::max(1, options_.maxBatch);
+    latencies_.reserve(kLatencyWindow);
+    dispatcher_ = std::thread(&SolveService::dispatchLoop, this);
+}
+
+SolveService::~SolveService() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    dispatcher_.join();
+}
+
+std::future<Matrix> SolveService::submit(Matrix system) {
+    Request request{std::move(system), std::promise<Matrix>(), Clock::now()};
+    std::future<Matrix> future = request.result.get_future();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stop_) throw std::runtime_error("Solve service is shutting down.");
+        queue_.push_back(std::move(request));
+    }
+    wake_.notify_one();
+    return future;
+}
+
+size_t SolveService::queueDepth() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queue_.size();
+}
+
+SolveServiceStats SolveService::stats() const {
+    SolveServiceStats s;
+    std::vector<double> sorted;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        s.queueDepth = queue_.size();
+        s.completed = completed_;
+        s.batches = batches_;
+        s.batched = batched_;
+        sorted = latencies_;
+    }
+    std::sort(sorted.begin(), sorted.end());
+    s.p50Ms = percentile(sorted, 0.50);
+    s.p95Ms = percentile(sorted, 0.95);
+    s.p99Ms = percentile(sorted, 0.99);
+    s.maxMs = sorted.empty() ? 0.0 : sorted.back();
+    return s;
+}
+
+void SolveService::finished(Request &request) {
+    double ms = std::chrono::duration<double, std::milli>(Clock::now() - request.submitted).count();
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (latencies_.size() < kLatencyWindow) {
+        latencies_.push_back(ms);
+    } else {
+        latencies_[latencyNext_] = ms;
+        latencyNext_ = (latencyNext_ + 1) % kLatencyWindow;
+    }
+    ++completed_;
+}
+
+void SolveService::solveLarge(Request &request) {
+    try {
+        gaussJordanParallel(request.system, *pool_, options_.kernel);
+        finished(request);
+        request.result.set_value(std::move(request.system));
+    } catch (...) {
+        finished(request);
+        request.result.set_exception(std::current_exception());
+    }
+}
+
+void SolveService::solveBatch(std::vector<Request> &requests) {
+    if (requests.size() == 1) {
+        // Nobody to share the vector lanes with
+        Request &r = requests.front();
+        try {
+            gaussJordanSequential(r.system, options_.kernel);
+            finished(r);
+            r.result.set_value(std::move(r.system));
+        } catch (...) {
+            finished(r);
+            r.result.set_exception(std::current_exception());
+        }
+        return;
+    }
+
+    const Matrix &first = requests.front().system;
+    std::unique_ptr<MatrixBatch> batch;
+    try {
+        batch.reset(new MatrixBatch(static_cast<int>(requests.size()), first.n, first.rhs));
+        for (size_t s = 0; s < requests.size(); ++s) batch->setSystem(static_cast<int>(s), requests[s].system);
+        gaussJordanBatched(*batch, *pool_);
+    } catch (...) {
+        // An exception here would end the dispatcher thread; every client of
+        // the group gets it from get() instead
+        for (Request &r : requests) {
+            finished(r);
+            r.result.set_exception(std::current_exception());
+        }
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++batches_;
+        batched_ += requests.size();
+    }
+    for (size_t s = 0; s < requests.size(); ++s) {
+        Request &r = requests[s];
+        finished(r);
+        if (batch->singular(static_cast<int>(s))) {
+            r.result.set_exception(std::make_exception_ptr(
+                std::runtime_error("Matrix is singular or nearly singular (pivot ~ 0).")));
+            continue;
+        }
+        try {
+            r.result.set_value(batch->system(static_cast<int>(s)));
+        } catch (...) {
+            r.result.set_exception(std::current_exception());
+        }
+    }
+}
+
+void SolveService::dispatchLoop() {
+    pool_.reset(new ThreadPool(options_.threads));
+    const size_t maxBatch = static_cast<size_t>(options_.maxBatch);
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        wake_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+        if (queue_.empty()) return; // stopping and drained
+
+        if (!isSmall(queue_.front())) {
+            Request request = std::move(queue_.front());
+            queue_.pop_front();
+            lock.unlock();
+            solveLarge(request);
+            lock.lock();
+            continue;
+        }
+
+        const int n = queue_.front().system.n, rhs = queue_.front().system.rhs;
+        auto sameShape = [n, rhs](const Request &r) { return r.system.n == n && r.system.rhs == rhs; };
+        size_t same = static_cast<size_t>(std::count_if(queue_.begin(), queue_.end(), sameShape));
+        Clock::time_point deadline = queue_.front().submitted + options_.batchWindow;
+        if (same < maxBatch && !stop_ && Clock::now() < deadline) {
+            // Let the group fill up; a large system further back can run meanwhile
+            auto large = std::find_if(queue_.begin(), queue_.end(), [this](const Request &r) { return !isSmall(r); });
+            if (large != queue_.end()) {
+                Request request = std::move(*large);
+                queue_.erase(large);
+                lock.unlock();
+                solveLarge(request);
+                lock.lock();
+            } else {
+                wake_.wait_until(lock, deadline);
+            }
+            continue;
+        }
+
+        // Oldest first, up to maxBatch systems of the head's shape
+        std::vector<Request> group;
+        for (auto it = queue_.begin(); it != queue_.end() && group.size() < maxBatch;) {
+            if (sameShape(*it)) {
+                group.push_back(std::move(*it));
+                it = queue_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        lock.unlock();
+        solveBatch(group);
+        lock.lock();
+    }
+}
@@ -0,0 +1,98 @@
+#ifndef SRC_SOLVE_SERVICE_H
+#define SRC_SOLVE_SERVICE_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "src_gauss_jordan.h"
+
+class ThreadPool;
+
+struct SolveServiceOptions {
+    unsigned threads = 0;  // total thread budget of the service, 0 = hardware_concurrency
+    int smallSize = 64;    // systems with n <= smallSize are batched
+    int maxBatch = 256;    // systems per batch
+    std::chrono::microseconds batchWindow{200}; // longest wait of a small system for company
+    RowKernel kernel = RowKernel::Cpp;          // row update for the large solves
+};
+
+struct SolveServiceStats {
+    size_t queueDepth = 0;  // submitted, not yet started
+    uint64_t completed = 0; // results delivered (solutions and errors)
+    uint64_t batches = 0;   // batched solves run
+    uint64_t batched = 0;   // requests that went through them
+    // Submit-to-result latency over the last kLatencyWindow requests, ms
+    double p50Ms = 0.0;
+    double p95Ms = 0.0;
+    double p99Ms = 0.0;
+    double maxMs = 0.0;
+};
+
+// Asynchronous front end for callers that solve many systems concurrently.
+//
+// submit() queues a system and returns at once with a future. One dispatcher
+// thread owns a ThreadPool sized to the thread budget (the dispatcher is its
+// thread 0), so however many callers there are, the service never runs more
+// than `threads` solver threads:
+//   - small systems (n <= smallSize) of the same n and rhs are grouped into a
+//     MatrixBatch and solved by gaussJordanBatched; a group is dispatched when
+//     it is full or its oldest member has waited batchWindow
+//   - larger systems are solved one at a time by gaussJordanParallel on the
+//     whole pool
+// Requests are taken oldest first; a large system behind a waiting small group
+// runs while the group fills up.
+class SolveService {
+public:
+    static constexpr size_t kLatencyWindow = 4096;
+
+    explicit SolveService(const SolveServiceOptions &options = SolveServiceOptions());
+    // Solves everything still queued, then stops the dispatcher
+    ~SolveService();
+
+    SolveService(const SolveService &) = delete;
+    SolveService &operator=(const SolveService &) = delete;
+
+    // The future yields the solved [I|X] (as gaussJordanSequential leaves it),
+    // or rethrows the solver's error (std::runtime_error for a singular A)
+    std::future<Matrix> submit(Matrix system);
+
+    size_t queueDepth() const;
+    SolveServiceStats stats() const;
+
+private:
+    struct Request {
+        Matrix system;
+        std::promise<Matrix> result;
+        std::chrono::steady_clock::time_point submitted;
+    };
+
+    bool isSmall(const Request &r) const { return r.system.n <= options_.smallSize; }
+    void dispatchLoop();
+    void solveLarge(Request &request);
+    void solveBatch(std::vector<Request> &requests);
+    void finished(Request &request);
+
+    SolveServiceOptions options_;
+    std::unique_ptr<ThreadPool> pool_; // created and used by the dispatcher only
+
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    std::deque<Request> queue_;
+    bool stop_ = false;
+
+    std::vector<double> latencies_; // ring of the last kLatencyWindow, ms
+    size_t latencyNext_ = 0;
+    uint64_t completed_ = 0;
+    uint64_t batches_ = 0;
+    uint64_t batched_ = 0;
+
+    std::thread dispatcher_;
+};
+
+#endif // SRC_SOLVE_SERVICE_H
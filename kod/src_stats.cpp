@@ -0,0 +1,14 @@
+#include "src_stats.h"
+#include <cmath>
+
+double percentile(const std::vector<double> &sorted, double p) {
+    if (sorted.empty()) return 0.0;
+    size_t rank = static_cast<size_t>(std::ceil(p * sorted.size()));
+    return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+double median(const std::vector<double> &sorted) {
+    size_t k = sorted.size();
+    if (k == 0) return 0.0;
+    return k % 2 ? sorted[k / 2] : 0.5 * (sorted[k / 2 - 1] + sorted[k / 2]);
+}
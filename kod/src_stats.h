@@ -0,0 +1,15 @@
+#ifndef SRC_STATS_H
+#define SRC_STATS_H
+
+#include <vector>
+
+// Summaries of timing samples, shared by the benchmark and the solve service.
+// Both take the samples already sorted ascending and return 0 for none.
+
+// Nearest-rank percentile, p in [0, 1]
+double percentile(const std::vector<double> &sorted, double p);
+
+// Middle sample, or the mean of the two middle ones
+double median(const std::vector<double> &sorted);
+
+#endif // SRC_STATS_H
@@ -0,0 +1,140 @@
+#include "src_thread_pool.h"
+#include "src_numa.h"
+#include <map>
+#include <memory>
+#include <utility>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// Spin iterations before a waiter gives up its core
+constexpr int kSpinCount = 512;
+constexpr int kYieldCount = 16;
+
+void futexWait(std::atomic<uint32_t> &word, uint32_t expected) {
+#if defined(__linux__)
+    syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAIT_PRIVATE, expected,
+            nullptr, nullptr, 0);
+#else
+    (void)word;
+    (void)expected;
+    std::this_thread::yield();
+#endif
+}
+
+void futexWakeAll(std::atomic<uint32_t> &word) {
+#if defined(__linux__)
+    syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAKE_PRIVATE, INT32_MAX,
+            nullptr, nullptr, 0);
+#else
+    (void)word;
+#endif
+}
+
+// Wait until `word` no longer holds `old`: spin, then yield, then sleep.
+void waitWhileEqual(std::atomic<uint32_t> &word, uint32_t old, std::atomic<unsigned> &sleepers) {
+    for (int i = 0; i < kSpinCount; ++i) {
+        if (word.load(std::memory_order_acquire) != old) return;
+        cpuRelax();
+    }
+    for (int i = 0; i < kYieldCount; ++i) {
+        if (word.load(std::memory_order_acquire) != old) return;
+        std::this_thread::yield();
+    }
+    while (word.load(std::memory_order_acquire) == old) {
+        sleepers.fetch_add(1, std::memory_order_seq_cst);
+        futexWait(word, old);
+        sleepers.fetch_sub(1, std::memory_order_seq_cst);
+    }
+}
+
+unsigned resolveThreadCount(unsigned threadCount) {
+    if (threadCount == 0) {
+        unsigned hw = std::thread::hardware_concurrency();
+        threadCount = hw > 0 ? hw : 1;
+    }
+    return threadCount;
+}
+
+void bumpAndWake(std::atomic<uint32_t> &word, std::atomic<unsigned> &sleepers) {
+    word.fetch_add(1, std::memory_order_seq_cst);
+    if (sleepers.load(std::memory_order_seq_cst) != 0) futexWakeAll(word);
+}
+
+} // namespace
+
+SpinBarrier::SpinBarrier(unsigned count) : count_(count > 0 ? count : 1) {}
+
+void SpinBarrier::arriveAndWait() {
+    uint32_t gen = generation_.load(std::memory_order_acquire);
+    if (arrived_.fetch_add(1, std::memory_order_acq_rel) + 1 == count_) {
+        arrived_.store(0, std::memory_order_relaxed);
+        bumpAndWake(generation_, sleepers_);
+        return;
+    }
+    waitWhileEqual(generation_, gen, sleepers_);
+}
+
+ThreadPool::ThreadPool(unsigned threadCount, ThreadPlacement placement)
+    : barrier_(resolveThreadCount(threadCount)), done_(resolveThreadCount(threadCount)) {
+    threadCount = resolveThreadCount(threadCount);
+    if (placement == ThreadPlacement::Pinned) cpus_ = NumaTopology::system().placement(threadCount);
+    workers_.reserve(threadCount - 1);
+    for (unsigned t = 1; t < threadCount; ++t)
+        workers_.emplace_back(&ThreadPool::workerLoop, this, t);
+}
+
+ThreadPool::~ThreadPool() {
+    stop_.store(true, std::memory_order_release);
+    bumpAndWake(epoch_, sleepers_);
+    for (auto &th : workers_) th.join();
+}
+
+void ThreadPool::runJob(unsigned tid) {
+    try {
+        (*job_)(tid);
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(errorMutex_);
+        if (!error_) error_ = std::current_exception();
+    }
+}
+
+void ThreadPool::workerLoop(unsigned tid) {
+    if (!cpus_.empty()) pinCurrentThread(cpus_[tid]);
+    uint32_t seen = 0; // epoch_ starts at 0; run() may bump it before we get here
+    for (;;) {
+        waitWhileEqual(epoch_, seen, sleepers_);
+        seen = epoch_.load(std::memory_order_acquire);
+        if (stop_.load(std::memory_order_acquire)) return;
+        runJob(tid);
+        done_.arriveAndWait();
+    }
+}
+
+void ThreadPool::run(const std::function<void(unsigned)> &job) {
+    std::lock_guard<std::mutex> lock(runMutex_);
+    std::unique_ptr<ScopedCpuPin> pin;
+    if (!cpus_.empty()) pin.reset(new ScopedCpuPin(cpus_[0]));
+    job_ = &job;
+    error_ = nullptr;
+    bumpAndWake(epoch_, sleepers_);
+    runJob(0);
+    done_.arriveAndWait();
+    job_ = nullptr;
+    if (error_) std::rethrow_exception(error_);
+}
+
+ThreadPool &ThreadPool::shared(unsigned threadCount, ThreadPlacement placement) {
+    static std::mutex mutex;
+    static std::map<std::pair<unsigned, ThreadPlacement>, std::unique_ptr<ThreadPool>> pools;
+    threadCount = resolveThreadCount(threadCount);
+    std::lock_guard<std::mutex> lock(mutex);
+    auto &slot = pools[std::make_pair(threadCount, placement)];
+    if (!slot) slot.reset(new ThreadPool(threadCount, placement));
+    return *slot;
+}
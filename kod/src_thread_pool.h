@@ -0,0 +1,106 @@
+#ifndef SRC_THREAD_POOL_H
+#define SRC_THREAD_POOL_H
+
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+inline void cpuRelax() { _mm_pause(); }
+#elif defined(__aarch64__)
+inline void cpuRelax() { asm volatile("yield"); }
+#else
+inline void cpuRelax() {}
+#endif
+
+// Busy-wait until pred() holds; gives the core away after a short spin so a
+// waiter never starves the thread it is waiting for.
+template <typename Pred>
+void spinUntil(Pred pred) {
+    for (int i = 0; !pred(); ++i) {
+        if (i < 256) cpuRelax();
+        else std::this_thread::yield();
+    }
+}
+
+// Reusable barrier: waiters spin for a short while and then park on a futex
+// (Linux) so that short phases stay cheap and long ones do not burn cores.
+class SpinBarrier {
+public:
+    explicit SpinBarrier(unsigned count = 1);
+
+    // Block until `count` threads have arrived. Safe to call repeatedly.
+    void arriveAndWait();
+
+private:
+    unsigned count_;
+    std::atomic<unsigned> arrived_{0};
+    std::atomic<uint32_t> generation_{0};
+    std::atomic<unsigned> sleepers_{0};
+};
+
+// Floating threads go wherever the scheduler puts them. Pinned threads are
+// bound to the CPUs of NumaTopology::system().placement() (see src_numa.h):
+// workers for their lifetime, the calling thread while it runs a job.
+enum class ThreadPlacement { Floating, Pinned };
+
+// Long-lived pool of worker threads. The calling thread takes part in every
+// job as thread 0, so a pool of size T starts only T-1 std::threads.
+class ThreadPool {
+public:
+    // 0 -> hardware_concurrency
+    explicit ThreadPool(unsigned threadCount = 0, ThreadPlacement placement = ThreadPlacement::Floating);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    unsigned size() const { return static_cast<unsigned>(workers_.size()) + 1; }
+
+    // CPU that thread `tid` is bound to, -1 for a floating pool
+    int cpuOf(unsigned tid) const { return cpus_.empty() ? -1 : cpus_[tid]; }
+
+    // Run job(tid) on every thread of the pool (tid in [0, size())) and wait
+    // for all of them. The first exception thrown by any thread is rethrown.
+    // Jobs that synchronize on barrier() must not throw between two waits.
+    void run(const std::function<void(unsigned)> &job);
+
+    // Barrier sized to the pool, for use inside run() jobs.
+    SpinBarrier &barrier() { return barrier_; }
+
+    // Process-wide pool with exactly threadCount threads, created on first use.
+    static ThreadPool &shared(unsigned threadCount, ThreadPlacement placement = ThreadPlacement::Floating);
+
+private:
+    void workerLoop(unsigned tid);
+    void runJob(unsigned tid);
+
+    std::vector<int> cpus_; // per tid; empty when floating
+    std::vector<std::thread> workers_;
+    const std::function<void(unsigned)> *job_ = nullptr;
+    std::atomic<uint32_t> epoch_{0};
+    std::atomic<unsigned> sleepers_{0};
+    std::atomic<bool> stop_{false};
+    SpinBarrier barrier_;
+    SpinBarrier done_;
+    std::mutex runMutex_;   // serializes concurrent run() callers
+    std::mutex errorMutex_;
+    std::exception_ptr error_;
+};
+
+// Split [0, total) into `parts` contiguous chunks, the first total % parts of
+// them one element longer; returns chunk `index` as [begin, end).
+inline void splitRange(int total, unsigned parts, unsigned index, int &begin, int &end) {
+    int base = total / static_cast<int>(parts);
+    int remainder = total % static_cast<int>(parts);
+    int i = static_cast<int>(index);
+    begin = i * base + (i < remainder ? i : remainder);
+    end = begin + base + (i < remainder ? 1 : 0);
+}
+
+#endif // SRC_THREAD_POOL_H
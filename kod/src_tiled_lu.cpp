@@ -0,0 +1,152 @@
+#include "src_tiled_lu.h"
+#include "src_lu.h"
+#include "src_thread_pool.h"
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+
+namespace {
+
+enum TaskKind { Panel, Swap, Update };
+
+// Swap columns [c0, c1) of rows a and b; the other column blocks may be at a
+// different step and keep their own row order until they get there
+inline void swap_segment(std::vector<double *> &rows, int a, int b, int c0, int c1) {
+    std::swap_ranges(rows[a] + c0, rows[a] + c1, rows[b] + c0);
+}
+
+// Unblocked LU of columns [k0, k1) over rows [k0, n)
+void factor_panel(std::vector<double *> &rows, int n, int k0, int k1, std::vector<int> &pivots, double tiny) {
+    for (int k = k0; k < k1; ++k) {
+        int pivot_row = k;
+        double maxval = std::abs(rows[k][k]);
+        for (int i = k + 1; i < n; ++i) {
+            double v = std::abs(rows[i][k]);
+            if (v > maxval) {
+                maxval = v;
+                pivot_row = i;
+            }
+        }
+        if (maxval <= tiny) {
+            throw std::runtime_error("Matrix is singular or nearly singular (pivot ~ 0).");
+        }
+        pivots[k] = pivot_row;
+        if (pivot_row != k) swap_segment(rows, k, pivot_row, k0, k1);
+
+        const double *rk = rows[k];
+        double inv_pivot = 1.0 / rk[k];
+        for (int i = k + 1; i < n; ++i) {
+            double *ri = rows[i];
+            double l = ri[k] * inv_pivot;
+            ri[k] = l;
+            if (l == 0.0) continue;
+            for (int j = k + 1; j < k1; ++j) ri[j] -= l * rk[j];
+        }
+    }
+}
+
+// Pivots of panel [k0, k1) on columns [j0, j1), then U = L11^-1 A for them
+void swap_and_solve(std::vector<double *> &rows, int k0, int k1, int j0, int j1, const std::vector<int> &pivots) {
+    for (int k = k0; k < k1; ++k) {
+        if (pivots[k] != k) swap_segment(rows, k, pivots[k], j0, j1);
+    }
+    for (int i = k0 + 1; i < k1; ++i) {
+        double *ri = rows[i];
+        for (int p = k0; p < i; ++p) {
+            double l = ri[p];
+            if (l == 0.0) continue;
+            const double *rp = rows[p];
+            for (int j = j0; j < j1; ++j) ri[j] -= l * rp[j];
+        }
+    }
+}
+
+} // namespace
+
+SchedulerStats luSolveTiled(Matrix &matrix, ThreadPool &pool, int tileSize) {
+    const int n = matrix.n;
+    if (n == 0) return SchedulerStats();
+    const int nb = std::max(8, tileSize / 8 * 8); // whole micro-kernel columns per tile
+    const int width = matrix.stride;              // B and the zero padding ride along
+    const int nt = (n + nb - 1) / nb;             // row tiles = column blocks of A
+    const int ncb = nt + (width - n + nb - 1) / nb;
+
+    std::vector<double *> rows(n);
+    for (int i = 0; i < n; ++i) rows[i] = matrix.row(i);
+    std::vector<int> pivots(n);
+    const double tiny = pivotThreshold(matrix);
+
+    auto first = [n, nt, nb](int block) { return block < nt ? block * nb : n + (block - nt) * nb; };
+    auto last = [n, nt, nb, width](int block) {
+        return block < nt ? std::min(n, (block + 1) * nb) : std::min(width, n + (block - nt + 1) * nb);
+    };
+
+    // Tasks still to finish before panel(k) / swap(k, j) may run
+    std::unique_ptr<std::atomic<int>[]> panelDeps(new std::atomic<int>[nt]);
+    std::unique_ptr<std::atomic<int>[]> swapDeps(new std::atomic<int>[static_cast<size_t>(nt) * ncb]);
+    for (int k = 0; k < nt; ++k) {
+        panelDeps[k].store(k == 0 ? 0 : nt - k, std::memory_order_relaxed);            // update(k-1, i, k), i >= k
+        for (int j = 0; j < ncb; ++j) {
+            swapDeps[static_cast<size_t>(k) * ncb + j].store(1 + (k == 0 ? 0 : nt - k), // panel(k) + updates
+                                                             std::memory_order_relaxed);
+        }
+    }
+    auto release = [](std::atomic<int> &deps) { return deps.fetch_sub(1, std::memory_order_acq_rel) == 1; };
+
+    WorkStealingScheduler scheduler(pool);
+    auto execute = [&](const Task &t, unsigned worker) {
+        int k = t.a;
+        int k0 = first(k), k1 = last(k);
+        switch (t.kind) {
+        case Panel:
+            factor_panel(rows, n, k0, k1, pivots, tiny);
+            for (int j = k + 1; j < ncb; ++j) {
+                if (release(swapDeps[static_cast<size_t>(k) * ncb + j])) scheduler.spawn({Swap, k, j, 0}, worker);
+            }
+            break;
+        case Swap: {
+            int j = t.b;
+            swap_and_solve(rows, k0, k1, first(j), last(j), pivots);
+            // Spawned in reverse so that the owner pops the top tile first
+            for (int i = nt - 1; i > k; --i) scheduler.spawn({Update, k, i, j}, worker);
+            break;
+        }
+        case Update: {
+            int i = t.b, j = t.c;
+            luUpdateTile(rows, first(i), last(i), first(j), last(j), k0, k1);
+            if (j == k + 1 && j < nt) {
+                if (release(panelDeps[j])) scheduler.spawn({Panel, j, 0, 0}, worker);
+            } else if (k + 1 < nt) {
+                std::atomic<int> &deps = swapDeps[static_cast<size_t>(k + 1) * ncb + j];
+                if (release(deps)) scheduler.spawn({Swap, k + 1, j, 0}, worker);
+            }
+            break;
+        }
+        }
+    };
+    SchedulerStats stats = scheduler.run({Task{Panel, 0, 0, 0}}, execute);
+
+    // Later pivots still have to reach the L part of the earlier blocks
+    unsigned threadCount = pool.size();
+    pool.run([&](unsigned tid) {
+        int b0, b1;
+        splitRange(nt, threadCount, tid, b0, b1);
+        for (int j = b0; j < b1; ++j) {
+            for (int k = last(j); k < n; ++k) {
+                if (pivots[k] != k) swap_segment(rows, k, pivots[k], first(j), last(j));
+            }
+        }
+    });
+
+    luBackSubstitute(rows, n, n, matrix.rhs);
+    return stats;
+}
+
+SchedulerStats luSolveTiled(Matrix &matrix, unsigned threadCount, int tileSize) {
+    if (threadCount == 0) {
+        unsigned hw = std::thread::hardware_concurrency();
+        threadCount = hw > 0 ? hw : 1;
+    }
+    return luSolveTiled(matrix, ThreadPool::shared(threadCount), tileSize);
+}
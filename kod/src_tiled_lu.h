@@ -0,0 +1,30 @@
+#ifndef SRC_TILED_LU_H
+#define SRC_TILED_LU_H
+
+#include "src_gauss_jordan.h"
+#include "src_work_stealing.h"
+
+class ThreadPool;
+
+// LU with partial pivoting as a graph of tile tasks on a work-stealing
+// scheduler (src_work_stealing.h). [A|B] is cut into column blocks of
+// `tileSize` columns (the B columns included) and row tiles of as many rows.
+//
+//   panel(k)      factor column block k over rows [k0, n), choose its pivots
+//   swap(k, j)    apply the pivots of panel k to column block j, then
+//                 U(k, j) = L(k, k)^-1 A(k, j) (the triangular solve)
+//   update(k,i,j) A(i, j) -= L(i, k) U(k, j)
+//
+// panel(k+1) waits only for the updates of step k on column block k+1, and
+// swap(k+1, j) for those on block j, so the next panels start while the wide
+// updates of earlier steps are still running and no step ends in a barrier.
+// The B blocks take the same swaps and updates, which leaves L^-1 P B in
+// them; back substitution then yields X.
+//
+// On return the right-hand-side columns hold X, the A part holds L and U and
+// the rows of `matrix` are in the order P*A, as after luSolveBlocked().
+// Throws std::runtime_error for a singular A.
+SchedulerStats luSolveTiled(Matrix &matrix, ThreadPool &pool, int tileSize = 64);
+SchedulerStats luSolveTiled(Matrix &matrix, unsigned threadCount = 0, int tileSize = 64);
+
+#endif // SRC_TILED_LU_H
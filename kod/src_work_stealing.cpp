@@ -0,0 +1,90 @@
+#include "src_work_stealing.h"
+#include "src_thread_pool.h"
+
+WorkStealingScheduler::WorkStealingScheduler(ThreadPool &pool)
+    : pool_(pool), queues_(new WorkerQueue[pool.size()]) {}
+
+void WorkStealingScheduler::spawn(const Task &task, unsigned worker) {
+    outstanding_.fetch_add(1, std::memory_order_relaxed);
+    WorkerQueue &q = queues_[worker];
+    std::lock_guard<std::mutex> lock(q.mutex);
+    q.tasks.push_back(task);
+}
+
+bool WorkStealingScheduler::pop(unsigned worker, Task &task) {
+    WorkerQueue &q = queues_[worker];
+    std::lock_guard<std::mutex> lock(q.mutex);
+    if (q.tasks.empty()) return false;
+    task = q.tasks.back();
+    q.tasks.pop_back();
+    return true;
+}
+
+bool WorkStealingScheduler::steal(unsigned thief, Task &task) {
+    unsigned count = pool_.size();
+    for (unsigned d = 1; d < count; ++d) {
+        WorkerQueue &victim = queues_[(thief + d) % count];
+        std::unique_lock<std::mutex> lock(victim.mutex, std::try_to_lock);
+        if (!lock.owns_lock() || victim.tasks.empty()) continue;
+        task = victim.tasks.front();
+        victim.tasks.pop_front();
+        return true;
+    }
+    return false;
+}
+
+void WorkStealingScheduler::workerLoop(unsigned worker, const Execute &execute) {
+    WorkerQueue &own = queues_[worker];
+    Task task;
+    for (int idle = 0;;) {
+        bool found = pop(worker, task);
+        if (!found && steal(worker, task)) {
+            found = true;
+            ++own.stolen;
+        }
+        if (!found) {
+            if (outstanding_.load(std::memory_order_acquire) == 0 || failed_.load(std::memory_order_relaxed)) return;
+            // Same back-off as spinUntil: a waiting thief must not starve the
+            // thread whose task it is waiting for
+            if (++idle < 256) cpuRelax();
+            else std::this_thread::yield();
+            continue;
+        }
+        idle = 0;
+        if (!failed_.load(std::memory_order_relaxed)) {
+            try {
+                execute(task, worker);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(errorMutex_);
+                if (!error_) error_ = std::current_exception();
+                failed_.store(true, std::memory_order_relaxed);
+            }
+        }
+        ++own.executed;
+        // Release: whatever the task wrote is visible to a thread that sees the count drop
+        outstanding_.fetch_sub(1, std::memory_order_acq_rel);
+    }
+}
+
+SchedulerStats WorkStealingScheduler::run(const std::vector<Task> &roots, const Execute &execute) {
+    unsigned count = pool_.size();
+    for (unsigned w = 0; w < count; ++w) {
+        queues_[w].tasks.clear();
+        queues_[w].executed = queues_[w].stolen = 0;
+    }
+    outstanding_.store(0, std::memory_order_relaxed);
+    failed_.store(false, std::memory_order_relaxed);
+    error_ = nullptr;
+    // Deal the roots out so that every worker starts with something
+    for (size_t r = 0; r < roots.size(); ++r) spawn(roots[r], static_cast<unsigned>(r % count));
+
+    pool_.run([this, &execute](unsigned worker) { workerLoop(worker, execute); });
+
+    if (error_) std::rethrow_exception(error_);
+    SchedulerStats stats;
+    for (unsigned w = 0; w < count; ++w) {
+        stats.tasks += queues_[w].executed;
+        stats.steals += queues_[w].stolen;
+    }
+    return stats;
+}
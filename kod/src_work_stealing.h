@@ -0,0 +1,70 @@
+#ifndef SRC_WORK_STEALING_H
+#define SRC_WORK_STEALING_H
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class ThreadPool;
+
+// A task is named by a kind and up to three indices; what they mean is up to
+// the graph that spawns it (see src_tiled_lu.cpp)
+struct Task {
+    int kind;
+    int a;
+    int b;
+    int c;
+};
+
+struct SchedulerStats {
+    uint64_t tasks = 0;  // tasks executed
+    uint64_t steals = 0; // tasks taken from another worker's deque
+};
+
+// Work-stealing executor for a task graph that unfolds while it runs.
+//
+// Every pool thread owns a deque: it pushes the tasks it spawns and pops them
+// back LIFO (the newest task usually works on the data just produced), while
+// an idle thread steals the oldest task of another deque. Dependencies are
+// the graph's business: a task is spawned once the counters of the graph say
+// it is ready. The run ends when no task is queued or executing.
+class WorkStealingScheduler {
+public:
+    using Execute = std::function<void(const Task &task, unsigned worker)>;
+
+    explicit WorkStealingScheduler(ThreadPool &pool);
+
+    // Execute `roots` and everything they spawn on the pool. The first
+    // exception thrown by a task stops the run (queued tasks are dropped)
+    // and is rethrown here.
+    SchedulerStats run(const std::vector<Task> &roots, const Execute &execute);
+
+    // Queue `task` on the deque of `worker` (the worker calling execute)
+    void spawn(const Task &task, unsigned worker);
+
+private:
+    struct alignas(64) WorkerQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+        uint64_t executed = 0;
+        uint64_t stolen = 0;
+    };
+
+    bool pop(unsigned worker, Task &task);
+    bool steal(unsigned thief, Task &task);
+    void workerLoop(unsigned worker, const Execute &execute);
+
+    ThreadPool &pool_;
+    std::unique_ptr<WorkerQueue[]> queues_;
+    std::atomic<int64_t> outstanding_{0}; // spawned and not yet finished
+    std::atomic<bool> failed_{false};
+    std::mutex errorMutex_;
+    std::exception_ptr error_;
+};
+
+#endif // SRC_WORK_STEALING_H
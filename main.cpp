@@ -1,118 +1,167 @@
 #include <iostream>
 #include <vector>
 #include <iomanip>
+#include <limits>
+#include <sstream>
 #include <chrono>
 #include <thread>
+#include <cmath>
+#include <cstdlib>
+#include <string>
+#include "src_blur.h"
+#include "src_image.h"
+#include "src_pgm.h"
+#include "src_pool.h"
 
 
 using namespace std;
 
-// 2D rozmycie Gaussa
-vector<vector<double>> gaussianBlur2D(const vector<vector<double>>& input) {
-    vector<vector<double>> kernel = {
-            {0.06, 0.24, 0.40, 0.24, 0.06},
-            {0.24, 0.40, 0.60, 0.40, 0.24},
-            {0.40, 0.60, 1.00, 0.60, 0.40},
-            {0.24, 0.40, 0.60, 0.40, 0.24},
-            {0.06, 0.24, 0.40, 0.24, 0.06}
-    };
-
-    // Normalizacja kernela
-    double sumKernel = 0.0;
-    for (auto& row : kernel)
-        for (auto v : row)
-            sumKernel += v;
-    for (auto& row : kernel)
-        for (auto& v : row)
-            v /= sumKernel;
-
-    int rows = input.size();
-    int cols = input[0].size();
-    int half = kernel.size() / 2;
-
-    vector<vector<double>> output(rows, vector<double>(cols, 0.0));
-
-    // Dla każdego piksela
-    for (int i = 0; i < rows; i++) {
-        for (int j = 0; j < cols; j++) {
-            double sum = 0.0;
-
-            // Dla każdego elementu filtra
-            for (int ki = -half; ki <= half; ki++) {
-                for (int kj = -half; kj <= half; kj++) {
-                    int ni = i + ki;
-                    int nj = j + kj;
-
-                    // Sprawdzenie czy nie wychodzi poza obraz
-                    if (ni >= 0 && ni < rows && nj >= 0 && nj < cols) {
-                        sum += input[ni][nj] * kernel[ki + half][kj + half];
-                    }
-                }
-            }
-
-            output[i][j] = sum;
-        }
-    }
+// 2D rozmycie Gaussa o odchyleniu sigma (piksele spoza obrazu = 0)
+Image gaussianBlur2D(const Image& input, double sigma = 1.0) {
+    BlurOptions options;
+    options.border = BorderMode::Zero;
+    return gaussianBlur(input, sigma, options);
+}
 
-    return output;
+Image gaussianBlur2D_parallel(const Image& image, int threadCount, double sigma = 1.0,
+                              BorderMode border = BorderMode::Clamp) {
+    // 🔹 To samo rozmycie co gaussianBlur2D (FIR lub rekurencyjne wg sigma), tylko
+    // kafle i pasy rozdziela stała pula wątków
+    Image result(image.width, image.height);
+    BlurOptions options;
+    options.border = border;
+    gaussianBlur(image, result, sigma, options, WorkerPool::shared(max(threadCount, 1)));
+    return result;
 }
 
-vector<vector<double>> gaussianBlur2D_parallel(const vector<vector<double>>& image, int threadCount) {
-    int height = image.size();
-    int width = image[0].size();
-    vector<vector<double>> result(height, vector<double>(width, 0.0));
-
-    // kernel Gaussa (3x3)
-    vector<vector<double>> kernel = {
-            {1, 2, 1},
-            {2, 4, 2},
-            {1, 2, 1}
-    };
-    double sumKernel = 16.0;
-
-    auto worker = [&](int startY, int endY) {
-        for (int y = startY; y < endY; ++y) {
-            for (int x = 0; x < width; ++x) {
-                double sum = 0.0;
-                for (int ky = -1; ky <= 1; ++ky) {
-                    for (int kx = -1; kx <= 1; ++kx) {
-                        int iy = min(max(y + ky, 0), height - 1);
-                        int ix = min(max(x + kx, 0), width - 1);
-                        sum += image[iy][ix] * kernel[ky + 1][kx + 1];
-                    }
-                }
-                result[y][x] = sum / sumKernel;
-            }
+// Czasy rozmycia obrazu całkowitego: przez double (kanał po kanale) i
+// stałoprzecinkowo; do tego największa różnica wyników w LSB
+template <typename T>
+static string compareFixed(const PixelImage<T>& image, const BlurKernel& kernel, const BlurOptions& options,
+                           WorkerPool& pool) {
+    const double top = numeric_limits<T>::max();
+    PixelImage<T> viaDouble(image.width, image.height, image.channels), direct = viaDouble;
+    auto t0 = chrono::high_resolution_clock::now();
+    for (int c = 0; c < image.channels; ++c) {
+        Image channel = image.channel(c), blurred(image.width, image.height);
+        blurImage(channel, blurred, kernel, options, pool);
+        for (int y = 0; y < image.height; ++y)
+            for (int x = 0; x < image.width; ++x)
+                viaDouble.at(x, y, c) = static_cast<T>(min(max(round(blurred.at(x, y)), 0.0), top));
+    }
+    auto t1 = chrono::high_resolution_clock::now();
+    blurImage(image, direct, kernel, options, pool);
+    auto t2 = chrono::high_resolution_clock::now();
+
+    int diff = 0;
+    for (int y = 0; y < image.height; ++y)
+        for (int x = 0; x < image.width * image.channels; ++x)
+            diff = max(diff, abs(int(direct.row(y)[x]) - int(viaDouble.row(y)[x])));
+    ostringstream line;
+    line << fixed << setprecision(1) << setw(17) << chrono::duration<double, milli>(t1 - t0).count()
+         << setw(24) << chrono::duration<double, milli>(t2 - t1).count() << setw(20) << diff;
+    return line.str();
+}
+
+// Tryb porównania: main --bench [rozmiar]. FIR kontra filtr rekurencyjny na
+// syntetycznym obrazie (szum + krawędzie): czasy i największa różnica
+static int benchmarkBlur(int argc, char** argv) {
+    int size = argc > 2 ? atoi(argv[2]) : 2048;
+    if (size <= 0) {
+        cerr << "Rozmiar musi byc dodatni\n";
+        return 1;
+    }
+    Image image(size, size);
+    unsigned state = 12345;
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            state = state * 1664525u + 1013904223u;
+            image.at(x, y) = ((x / 64 + y / 64) % 2 ? 192 : 64) + (state >> 24) % 64;
         }
-    };
+    }
 
-    // 🔹 Dzielimy obraz między wątki
-    vector<thread> threads;
-    int rowsPerThread = height / threadCount;
-    int startY = 0;
+    WorkerPool& pool = WorkerPool::shared(max<int>(thread::hardware_concurrency(), 1));
+    Image fir(size, size), iir(size, size);
+    BlurOptions options;
+    cout << "Obraz " << size << " x " << size << ", " << pool.size() << " watki\n";
+    cout << "   sigma     FIR [ms]     IIR [ms]   max |IIR-FIR|\n";
+    for (double sigma : {1.0, 2.0, 4.0, 8.0, 16.0}) {
+        auto t0 = chrono::high_resolution_clock::now();
+        gaussianBlur(image, fir, sigma, options, pool, BlurMethod::Fir);
+        auto t1 = chrono::high_resolution_clock::now();
+        gaussianBlur(image, iir, sigma, options, pool, BlurMethod::Recursive);
+        auto t2 = chrono::high_resolution_clock::now();
+        double diff = 0;
+        for (int y = 0; y < size; ++y)
+            for (int x = 0; x < size; ++x) diff = max(diff, abs(iir.at(x, y) - fir.at(x, y)));
+        cout << setw(8) << fixed << setprecision(1) << sigma
+             << setw(13) << chrono::duration<double, milli>(t1 - t0).count()
+             << setw(13) << chrono::duration<double, milli>(t2 - t1).count()
+             << setw(16) << setprecision(3) << diff << "\n";
+    }
 
-    for (int i = 0; i < threadCount; ++i) {
-        int endY = (i == threadCount - 1) ? height : startY + rowsPerThread;
-        threads.emplace_back(worker, startY, endY);
-        startY = endY;
+    // Obraz 8-bitowy RGB i 16-bitowy w skali szarości: blur stałoprzecinkowy
+    // kontra ten sam FIR w double (kanał po kanale) i różnica w LSB
+    Image8 rgb(size, size, 3);
+    Image16 gray(size, size);
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            for (int c = 0; c < 3; ++c) rgb.at(x, y, c) = static_cast<uint8_t>(static_cast<int>(image.at(x, y)) + 40 * c);
+            gray.at(x, y) = static_cast<uint16_t>(image.at(x, y) * 257);
+        }
     }
+    cout << "   sigma   obraz      double [ms]   staloprzecinkowo [ms]   max roznica [LSB]\n";
+    for (double sigma : {1.0, 2.0, 4.0}) {
+        BlurKernel kernel = gaussianKernel(sigma);
+        cout << setw(8) << setprecision(1) << sigma << "   uint8 x3"
+             << compareFixed(rgb, kernel, options, pool) << "\n";
+        cout << setw(8) << setprecision(1) << sigma << "   uint16  "
+             << compareFixed(gray, kernel, options, pool) << "\n";
+    }
+    return 0;
+}
 
-    // 🔹 Czekamy aż wszystkie wątki skończą
-    for (auto& t : threads)
-        t.join();
 
-    return result;
+// Tryb strumieniowy: main WEJSCIE.pgm WYJSCIE.pgm [sigma] [clamp|mirror|zero]
+static int blurFile(int argc, char** argv) {
+    double sigma = argc > 3 ? atof(argv[3]) : 2.0;
+    BorderMode border = BorderMode::Clamp;
+    if (argc > 4) {
+        string mode = argv[4];
+        if (mode == "mirror") border = BorderMode::Mirror;
+        else if (mode == "zero") border = BorderMode::Zero;
+        else if (mode != "clamp") {
+            cerr << "Nieznany tryb brzegu: " << mode << "\n";
+            return 1;
+        }
+    }
+    try {
+        RasterReader input(argv[1]);
+        RasterWriter output(argv[2], input.info());
+        cout << "Rozmycie strumieniowe " << input.info().width << " x " << input.info().height
+             << " (sigma " << sigma << ")...\n";
+        auto start = chrono::high_resolution_clock::now();
+        blurStream(input, output, gaussianKernel(sigma), border);
+        auto end = chrono::high_resolution_clock::now();
+        cout << "Czas wykonania: " << chrono::duration<double, milli>(end - start).count() << " ms\n";
+    } catch (const exception& ex) {
+        cerr << ex.what() << "\n";
+        return 1;
+    }
+    return 0;
 }
 
+int main(int argc, char** argv) {
+    if (argc >= 2 && string(argv[1]) == "--bench") return benchmarkBlur(argc, argv);
+    if (argc >= 3) return blurFile(argc, argv);
 
-int main() {
-    vector<vector<double>> image = {
+    Image image = Image::fromRows({
             {10, 20, 30, 40, 50},
             {20, 30, 40, 50, 60},
             {30, 40, 50, 60, 70},
             {40, 50, 60, 70, 80},
             {50, 60, 70, 80, 90}
-    };
+    });
 
     int threadCount = 4; // np. 4 wątki – możemy później zmieniać
 
@@ -127,7 +176,7 @@ int main() {
     cout << "Czas wykonania: " << duration.count() << " ms\n";
 
     cout << "Po rozmyciu:\n";
-    for (auto& row : blurred) {
+    for (auto& row : blurred.toRows()) {
         for (auto v : row)
             cout << setw(8) << fixed << setprecision(1) << v;
         cout << "\n";
@@ -0,0 +1,822 @@
+#include "src_blur.h"
+#include "src_pgm.h"
+#include "src_pool.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <future>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+
+namespace {
+
+#if defined(__GNUC__)
+// 4 double w jednym rejestrze AVX (bez -mavx kompilator składa je z dwóch SSE2)
+typedef double Lanes __attribute__((vector_size(4 * sizeof(double))));
+#endif
+
+// out[x] += sum_k taps[k] * src[x + k] dla x w [0, width); src ma width + count - 1
+// elementów (wiersz z dopisanym brzegiem), więc w pętli nie ma żadnych warunków
+void convolveRow(const double *src, int width, const double *taps, int count, double *out) {
+    int x = 0;
+#if defined(__GNUC__)
+    for (; x + 4 <= width; x += 4) {
+        Lanes acc;
+        std::memcpy(&acc, out + x, sizeof(acc));
+        for (int k = 0; k < count; ++k) {
+            Lanes v;
+            std::memcpy(&v, src + x + k, sizeof(v));
+            acc += taps[k] * v;
+        }
+        std::memcpy(out + x, &acc, sizeof(acc));
+    }
+#endif
+    for (; x < width; ++x) {
+        double sum = out[x];
+        for (int k = 0; k < count; ++k) sum += taps[k] * src[x + k];
+        out[x] = sum;
+    }
+}
+
+// out[x] = sum_k taps[k] * rows[k][x]: przebieg pionowy po gotowych wierszach
+void combineRows(const double *const *rows, const double *taps, int count, int width, double *out) {
+    int x = 0;
+#if defined(__GNUC__)
+    for (; x + 4 <= width; x += 4) {
+        Lanes acc = {};
+        for (int k = 0; k < count; ++k) {
+            Lanes v;
+            std::memcpy(&v, rows[k] + x, sizeof(v));
+            acc += taps[k] * v;
+        }
+        std::memcpy(out + x, &acc, sizeof(acc));
+    }
+#endif
+    for (; x < width; ++x) {
+        double sum = 0.0;
+        for (int k = 0; k < count; ++k) sum += taps[k] * rows[k][x];
+        out[x] = sum;
+    }
+}
+
+// Indeks piksela użytego zamiast i (może być spoza [0, n)); -1 = zero
+template <BorderMode B>
+struct Border;
+
+template <>
+struct Border<BorderMode::Zero> {
+    static int index(int i, int n) { return i >= 0 && i < n ? i : -1; }
+};
+
+template <>
+struct Border<BorderMode::Clamp> {
+    static int index(int i, int n) { return std::min(std::max(i, 0), n - 1); }
+};
+
+template <>
+struct Border<BorderMode::Mirror> {
+    static int index(int i, int n) {
+        if (n == 1) return 0;
+        // Odbicia powtarzają się co 2(n-1); działa też dla promienia > n
+        int period = 2 * (n - 1);
+        i %= period;
+        if (i < 0) i += period;
+        return i < n ? i : period - i;
+    }
+};
+
+// Kafel [x0, x0 + tw) x [y0, y0 + th) z halo r do dst (th + 2r wierszy po
+// tw + 2r elementów). Brzeg obsługują tylko wiersze/kolumny halo spoza obrazu;
+// środek to kopiowanie wierszy.
+template <BorderMode B>
+void loadTile(const Image &in, int x0, int y0, int tw, int th, int r, double *dst) {
+    const int ls = tw + 2 * r;
+    const int xa = std::max(0, x0 - r), xb = std::min(in.width, x0 + tw + r);
+    for (int t = 0; t < th + 2 * r; ++t) {
+        double *d = dst + static_cast<size_t>(t) * ls;
+        int sy = Border<B>::index(y0 - r + t, in.height);
+        if (sy < 0) {
+            std::fill(d, d + ls, 0.0);
+            continue;
+        }
+        const double *src = in.row(sy);
+        for (int x = x0 - r; x < xa; ++x) {
+            int sx = Border<B>::index(x, in.width);
+            d[x - x0 + r] = sx < 0 ? 0.0 : src[sx];
+        }
+        std::copy(src + xa, src + xb, d + (xa - x0 + r));
+        for (int x = xb; x < x0 + tw + r; ++x) {
+            int sx = Border<B>::index(x, in.width);
+            d[x - x0 + r] = sx < 0 ? 0.0 : src[sx];
+        }
+    }
+}
+
+// Bufory jednego wątku, używane ponownie przez kolejne kafle i wywołania
+thread_local std::vector<double> tileScratch;
+thread_local std::vector<double> passScratch;
+thread_local std::vector<const double *> rowScratch;
+
+template <BorderMode B>
+void blurTile(const Image &in, Image &out, const BlurKernel &kernel, int x0, int y0, int tw, int th) {
+    const int r = kernel.radius, k = kernel.size;
+    const int ls = tw + 2 * r;
+    tileScratch.resize(static_cast<size_t>(th + 2 * r) * ls);
+    loadTile<B>(in, x0, y0, tw, th, r, tileScratch.data());
+    const double *tile = tileScratch.data();
+
+    if (kernel.separable) {
+        // Przebieg poziomy po wszystkich wierszach kafla z halo, potem pionowy
+        passScratch.assign(static_cast<size_t>(th + 2 * r) * tw, 0.0);
+        for (int t = 0; t < th + 2 * r; ++t) {
+            convolveRow(tile + static_cast<size_t>(t) * ls, tw, kernel.row.data(), k,
+                        passScratch.data() + static_cast<size_t>(t) * tw);
+        }
+        rowScratch.resize(k);
+        for (int y = 0; y < th; ++y) {
+            for (int t = 0; t < k; ++t) rowScratch[t] = passScratch.data() + static_cast<size_t>(y + t) * tw;
+            combineRows(rowScratch.data(), kernel.column.data(), k, tw, out.row(y0 + y) + x0);
+        }
+        return;
+    }
+
+    // Jądro nieseparowalne: pełny splot, wierszami jądra
+    for (int y = 0; y < th; ++y) {
+        double *o = out.row(y0 + y) + x0;
+        std::fill(o, o + tw, 0.0);
+        for (int t = 0; t < k; ++t) {
+            convolveRow(tile + static_cast<size_t>(y + t) * ls, tw, kernel.taps.data() + static_cast<size_t>(t) * k,
+                        k, o);
+        }
+    }
+}
+
+struct TileGrid {
+    int tileWidth, tileHeight, columns, rows;
+
+    TileGrid(int width, int height, const BlurOptions &options)
+        : tileWidth(std::max(1, options.tileWidth)), tileHeight(std::max(1, options.tileHeight)),
+          columns((width + tileWidth - 1) / tileWidth), rows((height + tileHeight - 1) / tileHeight) {}
+
+    int count() const { return columns * rows; }
+};
+
+template <BorderMode B>
+void blurTileAt(const Image &in, Image &out, const BlurKernel &kernel, const TileGrid &grid, int index) {
+    int x0 = index % grid.columns * grid.tileWidth;
+    int y0 = index / grid.columns * grid.tileHeight;
+    blurTile<B>(in, out, kernel, x0, y0, std::min(grid.tileWidth, in.width - x0),
+                std::min(grid.tileHeight, in.height - y0));
+}
+
+// Wybór specjalizacji raz na wywołanie, nie na piksel
+template <typename F>
+void withBorder(BorderMode border, F &&f) {
+    switch (border) {
+    case BorderMode::Zero:
+        f(std::integral_constant<BorderMode, BorderMode::Zero>{});
+        break;
+    case BorderMode::Clamp:
+        f(std::integral_constant<BorderMode, BorderMode::Clamp>{});
+        break;
+    case BorderMode::Mirror:
+        f(std::integral_constant<BorderMode, BorderMode::Mirror>{});
+        break;
+    }
+}
+
+void checkSizes(const Image &input, const Image &output) {
+    if (input.width != output.width || input.height != output.height) {
+        throw std::invalid_argument("Output image must have the size of the input.");
+    }
+    if (&input == &output) throw std::invalid_argument("Blur cannot run in place.");
+}
+
+// Wiersz z dopisanym halo: dst[r + x] = src[x], reszta wg trybu brzegu
+template <BorderMode B>
+void padRow(const double *src, int width, int r, double *dst) {
+    for (int x = -r; x < 0; ++x) {
+        int sx = Border<B>::index(x, width);
+        dst[x + r] = sx < 0 ? 0.0 : src[sx];
+    }
+    std::copy(src, src + width, dst + r);
+    for (int x = width; x < width + r; ++x) {
+        int sx = Border<B>::index(x, width);
+        dst[x + r] = sx < 0 ? 0.0 : src[sx];
+    }
+}
+
+// Współczynniki filtra Younga-van Vlieta: y[n] = b * x[n] + a1 y[n-1] + a2 y[n-2] + a3 y[n-3]
+struct RecursiveGauss {
+    double b, a1, a2, a3;
+    int padding; // próbki brzegu dopisane z każdej strony linii
+
+    explicit RecursiveGauss(double sigma) {
+        double q = sigma >= 2.5 ? 0.98711 * sigma - 0.96330 : 3.97156 - 4.14554 * std::sqrt(1.0 - 0.26891 * sigma);
+        double q2 = q * q, q3 = q2 * q;
+        double b0 = 1.57825 + 2.44413 * q + 1.4281 * q2 + 0.422205 * q3;
+        a1 = (2.44413 * q + 2.85619 * q2 + 1.26661 * q3) / b0;
+        a2 = -(1.4281 * q2 + 1.26661 * q3) / b0;
+        a3 = 0.422205 * q3 / b0;
+        b = 1.0 - (a1 + a2 + a3);
+        // Odpowiedź filtra maleje jak exp(-n / q); po 4 sigma start ze stanu
+        // ustalonego nie wpływa już na wynik w granicach dokładności metody
+        padding = static_cast<int>(std::ceil(4.0 * sigma)) + 3;
+    }
+};
+
+// Wiersze [y, y + 4) (brakujące = 0) przeplecione po 4 w `line`, z dopisanym
+// brzegiem: line[(p + padding) * 4 + l] = wiersz y + l, kolumna p
+template <BorderMode B>
+void loadInterleaved(const Image &in, int y, int padding, double *line) {
+    const int width = in.width;
+    const double *src[4];
+    for (int l = 0; l < 4; ++l) src[l] = y + l < in.height ? in.row(y + l) : nullptr;
+    auto put = [&](int p, int sx) {
+        for (int l = 0; l < 4; ++l) line[(p + padding) * 4 + l] = sx < 0 || !src[l] ? 0.0 : src[l][sx];
+    };
+    for (int p = -padding; p < 0; ++p) put(p, Border<B>::index(p, width));
+    for (int p = 0; p < width; ++p) put(p, p);
+    for (int p = width; p < width + padding; ++p) put(p, Border<B>::index(p, width));
+}
+
+// Przebieg poziomy na 4 wierszach naraz: 4 niezależne rekurencje w jednym
+// wektorze, więc opóźnienie zależności jednej linii się nie sumuje
+void recursiveInterleaved(const RecursiveGauss &g, double *line, int count) {
+#if defined(__GNUC__)
+    Lanes x, w1, w2, w3;
+    std::memcpy(&w1, line, sizeof(w1));
+    w2 = w3 = w1;
+    for (int p = 0; p < count; ++p) {
+        std::memcpy(&x, line + static_cast<size_t>(p) * 4, sizeof(x));
+        Lanes w = g.b * x + g.a1 * w1 + g.a2 * w2 + g.a3 * w3;
+        std::memcpy(line + static_cast<size_t>(p) * 4, &w, sizeof(w));
+        w3 = w2;
+        w2 = w1;
+        w1 = w;
+    }
+    std::memcpy(&w1, line + static_cast<size_t>(count - 1) * 4, sizeof(w1));
+    w2 = w3 = w1;
+    for (int p = count - 1; p >= 0; --p) {
+        std::memcpy(&x, line + static_cast<size_t>(p) * 4, sizeof(x));
+        Lanes w = g.b * x + g.a1 * w1 + g.a2 * w2 + g.a3 * w3;
+        std::memcpy(line + static_cast<size_t>(p) * 4, &w, sizeof(w));
+        w3 = w2;
+        w2 = w1;
+        w1 = w;
+    }
+#else
+    for (int l = 0; l < 4; ++l) {
+        double *v = line + l;
+        double w1 = v[0], w2 = w1, w3 = w1;
+        for (int p = 0; p < count; ++p) {
+            double w = g.b * v[p * 4] + g.a1 * w1 + g.a2 * w2 + g.a3 * w3;
+            v[p * 4] = w;
+            w3 = w2;
+            w2 = w1;
+            w1 = w;
+        }
+        w1 = w2 = w3 = v[(count - 1) * 4];
+        for (int p = count - 1; p >= 0; --p) {
+            double w = g.b * v[p * 4] + g.a1 * w1 + g.a2 * w2 + g.a3 * w3;
+            v[p * 4] = w;
+            w3 = w2;
+            w2 = w1;
+            w1 = w;
+        }
+    }
+#endif
+}
+
+template <BorderMode B>
+void recursiveRows(const Image &in, Image &out, const RecursiveGauss &g, int y) {
+    const int count = in.width + 2 * g.padding;
+    tileScratch.resize(static_cast<size_t>(count) * 4);
+    loadInterleaved<B>(in, y, g.padding, tileScratch.data());
+    recursiveInterleaved(g, tileScratch.data(), count);
+    for (int l = 0; l < 4 && y + l < in.height; ++l) {
+        double *o = out.row(y + l);
+        for (int x = 0; x < in.width; ++x) o[x] = tileScratch[static_cast<size_t>(x + g.padding) * 4 + l];
+    }
+}
+
+// Przebieg pionowy na pasie kolumn [x0, x0 + n) obrazu `img`, w miejscu:
+// wiersz po wierszu, więc pętle po kolumnach się wektoryzują
+template <BorderMode B>
+void recursiveColumns(Image &img, const RecursiveGauss &g, int x0, int n) {
+    const int height = img.height, pad = g.padding;
+    passScratch.assign(static_cast<size_t>(4 + pad) * n, 0.0);
+    double *w1 = passScratch.data(), *w2 = w1 + n, *w3 = w2 + n, *w = w3 + n;
+    double *tail = w + n; // wiersze [height, height + pad) po przebiegu w przód
+    auto source = [&](int t) -> const double * {
+        int s = Border<B>::index(t, height);
+        return s < 0 ? nullptr : img.row(s) + x0;
+    };
+
+    // Wiersze za dolnym brzegiem wskazują na wiersze obrazu, które przebieg w
+    // przód nadpisze wcześniej, więc ich źródła trzeba skopiować przed nim
+    for (int t = 0; t < pad; ++t) {
+        const double *x = source(height + t);
+        double *d = tail + static_cast<size_t>(t) * n;
+        if (x) std::copy(x, x + n, d);
+        else std::fill(d, d + n, 0.0);
+    }
+
+    const double *first = source(-pad);
+    for (int c = 0; c < n; ++c) w1[c] = w2[c] = w3[c] = first ? first[c] : 0.0;
+    for (int t = -pad; t < height + pad; ++t) {
+        const double *x = t < height ? source(t) : tail + static_cast<size_t>(t - height) * n;
+        double *dst = t < 0 ? w : t < height ? img.row(t) + x0 : tail + static_cast<size_t>(t - height) * n;
+        for (int c = 0; c < n; ++c) dst[c] = g.b * (x ? x[c] : 0.0) + g.a1 * w1[c] + g.a2 * w2[c] + g.a3 * w3[c];
+        std::copy(w2, w2 + n, w3);
+        std::copy(w1, w1 + n, w2);
+        std::copy(dst, dst + n, w1);
+    }
+
+    const double *last = tail + static_cast<size_t>(pad - 1) * n;
+    for (int c = 0; c < n; ++c) w1[c] = w2[c] = w3[c] = last[c];
+    for (int t = height + pad - 1; t >= 0; --t) {
+        double *v = t < height ? img.row(t) + x0 : tail + static_cast<size_t>(t - height) * n;
+        for (int c = 0; c < n; ++c) {
+            double y = g.b * v[c] + g.a1 * w1[c] + g.a2 * w2[c] + g.a3 * w3[c];
+            w3[c] = w2[c];
+            w2[c] = w1[c];
+            w1[c] = y;
+            v[c] = y;
+        }
+    }
+}
+
+template <BorderMode B>
+void blurStreamRows(RasterReader &input, RasterWriter &output, const BlurKernel &kernel, int blockRows) {
+    const int width = input.info().width, height = input.info().height;
+    const int r = kernel.radius, k = kernel.size;
+    const int padded = width + 2 * r;
+    // Pierścień: wiersz źródła s w slocie s % k. Wiersz wyjścia y potrzebuje
+    // źródeł z [y - r, y + r] (tryby clamp i mirror też nie wychodzą poza to
+    // okno), więc k slotów wystarcza.
+    const int slot = kernel.separable ? width : padded;
+    std::vector<double> ring(static_cast<size_t>(k) * slot);
+    std::vector<double> line(padded), zeros(slot, 0.0);
+    std::vector<const double *> rows(k);
+
+    // Dwa bufory na blok wejścia i dwa na blok wyjścia: jeden liczony, drugi w tle
+    std::vector<double> inBlock[2], outBlock[2];
+    for (int i = 0; i < 2; ++i) {
+        inBlock[i].resize(static_cast<size_t>(blockRows) * width);
+        outBlock[i].resize(static_cast<size_t>(blockRows) * width);
+    }
+    auto readBlock = [&input, width, height, blockRows](std::vector<double> *dst, int first) {
+        input.readRows(dst->data(), std::min(blockRows, height - first), width);
+    };
+
+    std::future<void> reading = std::async(std::launch::async, readBlock, &inBlock[0], 0);
+    std::future<void> writing;
+    int outBuf = 0, outRows = 0, next = 0;
+
+    auto emitRow = [&](int y) {
+        for (int t = 0; t < k; ++t) {
+            int s = Border<B>::index(y - r + t, height);
+            rows[t] = s < 0 ? zeros.data() : ring.data() + static_cast<size_t>(s % k) * slot;
+        }
+        double *o = outBlock[outBuf].data() + static_cast<size_t>(outRows) * width;
+        if (kernel.separable) {
+            combineRows(rows.data(), kernel.column.data(), k, width, o);
+        } else {
+            std::fill(o, o + width, 0.0);
+            for (int t = 0; t < k; ++t) {
+                convolveRow(rows[t], width, kernel.taps.data() + static_cast<size_t>(t) * k, k, o);
+            }
+        }
+        if (++outRows == blockRows || y == height - 1) {
+            if (writing.valid()) writing.get();
+            writing = std::async(std::launch::async, [&output, width](const std::vector<double> *src, int count) {
+                output.writeRows(src->data(), count, width);
+            }, &outBlock[outBuf], outRows);
+            outBuf ^= 1;
+            outRows = 0;
+        }
+    };
+
+    for (int first = 0, buf = 0; first < height; first += blockRows, buf ^= 1) {
+        reading.get();
+        if (first + blockRows < height) reading = std::async(std::launch::async, readBlock, &inBlock[buf ^ 1],
+                                                             first + blockRows);
+        int count = std::min(blockRows, height - first);
+        for (int i = 0; i < count; ++i) {
+            int s = first + i;
+            const double *src = inBlock[buf].data() + static_cast<size_t>(i) * width;
+            double *dst = ring.data() + static_cast<size_t>(s % k) * slot;
+            if (kernel.separable) {
+                padRow<B>(src, width, r, line.data());
+                std::fill(dst, dst + width, 0.0);
+                convolveRow(line.data(), width, kernel.row.data(), k, dst);
+            } else {
+                padRow<B>(src, width, r, dst);
+            }
+            // Wiersze, których okno [y - r, y + r] jest już w pierścieniu
+            for (; next < height && (next + r <= s || s == height - 1); ++next) emitRow(next);
+        }
+    }
+    if (writing.valid()) writing.get();
+    output.flush();
+}
+
+// Arytmetyka stałoprzecinkowa dla próbek T: typ akumulatora i jego wektor,
+// liczba bitów wartości, której akumulator nie może przekroczyć, oraz bity
+// ułamka zostawiane po przebiegu poziomym
+template <typename T>
+struct Fixed;
+
+template <>
+struct Fixed<uint8_t> {
+    typedef int32_t Acc;
+#if defined(__GNUC__)
+    typedef int32_t Lanes __attribute__((vector_size(8 * sizeof(int32_t))));
+    typedef uint8_t Narrow __attribute__((vector_size(8 * sizeof(uint8_t))));
+#endif
+    static constexpr int kAccBits = 31;
+    static constexpr int kMidFraction = 4;
+};
+
+template <>
+struct Fixed<uint16_t> {
+    // 16 bitów próbki i ok. 20 bitów tapu już nie mieszczą się w int32
+    typedef int64_t Acc;
+#if defined(__GNUC__)
+    typedef int64_t Lanes __attribute__((vector_size(4 * sizeof(int64_t))));
+    typedef uint16_t Narrow __attribute__((vector_size(4 * sizeof(uint16_t))));
+#endif
+    static constexpr int kAccBits = 63;
+    static constexpr int kMidFraction = 8;
+};
+
+// Najmniejsze n >= 0, dla którego 2^n >= s
+int ceilLog2(double s) { return s <= 1.0 ? 0 : static_cast<int>(std::ceil(std::log2(s))); }
+
+double absSum(const std::vector<double> &taps) {
+    double sum = 0.0;
+    for (double v : taps) sum += std::fabs(v);
+    return sum;
+}
+
+// round(taps * 2^shift); różnicę sum po zaokrągleniu dostaje największy tap,
+// więc suma całkowitych tapów to dokładnie round(suma * 2^shift) i po
+// znormalizowanym jądrze stały obraz zostaje stały
+template <typename A>
+std::vector<A> quantizeTaps(const std::vector<double> &taps, int shift) {
+    const double scale = std::ldexp(1.0, shift);
+    std::vector<A> q(taps.size());
+    double sum = 0.0;
+    long long qsum = 0;
+    size_t big = 0;
+    for (size_t i = 0; i < taps.size(); ++i) {
+        q[i] = static_cast<A>(std::llround(taps[i] * scale));
+        sum += taps[i];
+        qsum += q[i];
+        if (std::fabs(taps[i]) > std::fabs(taps[big])) big = i;
+    }
+    q[big] += static_cast<A>(std::llround(sum * scale) - qsum);
+    return q;
+}
+
+// Jądro w liczbach całkowitych dla próbek T. Tap ma `shift` bitów ułamka,
+// najwięcej tyle, żeby |próbka| * sum|tap| * 2^shift < 2^(kAccBits - 1) (zapas
+// na stałą zaokrąglenia), i nie więcej niż 30. Dla 8 bitów to 22 bity w
+// przebiegu poziomym i 18 w pionowym: błąd kwantyzacji tapów jest wtedy dużo
+// mniejszy od 1/2 LSB.
+template <typename T>
+struct FixedKernel {
+    typedef typename Fixed<T>::Acc Acc;
+
+    int size, radius;
+    bool separable;
+    std::vector<Acc> taps, row, column;
+    int tapShift = 0, rowShift = 0, columnShift = 0;
+
+    explicit FixedKernel(const BlurKernel &kernel)
+        : size(kernel.size), radius(kernel.radius), separable(kernel.separable) {
+        const int room = Fixed<T>::kAccBits - 1, sampleBits = 8 * sizeof(T);
+        if (separable) {
+            const int rowBits = ceilLog2(absSum(kernel.row));
+            const int midBits = sampleBits + Fixed<T>::kMidFraction + rowBits;
+            rowShift = std::min(30, room - sampleBits - rowBits);
+            columnShift = std::min(30, room - midBits - ceilLog2(absSum(kernel.column)));
+            if (rowShift < Fixed<T>::kMidFraction || columnShift < 1) tooLarge();
+            row = quantizeTaps<Acc>(kernel.row, rowShift);
+            column = quantizeTaps<Acc>(kernel.column, columnShift);
+        } else {
+            tapShift = std::min(30, room - sampleBits - ceilLog2(absSum(kernel.taps)));
+            if (tapShift < 1) tooLarge();
+            taps = quantizeTaps<Acc>(kernel.taps, tapShift);
+        }
+    }
+
+    [[noreturn]] static void tooLarge() {
+        throw std::invalid_argument("Kernel taps are too large for fixed-point blur.");
+    }
+};
+
+// out[e] = (2^(shift-1) + sum_t sum_j taps[t * count + j] * rows[t][e + j * step]) >> shift
+// dla e w [0, n). Jeden wzór na trzy przebiegi: poziomy (1 wiersz, step =
+// liczba kanałów, Out = akumulator), pionowy (count = 1) i pełny 2D; gdy Out
+// to typ próbki, wynik jest obcinany do [0, max] dopiero tutaj.
+template <typename T, typename Out>
+void convolveFixed(const typename Fixed<T>::Acc *const *rows, int rowCount, const typename Fixed<T>::Acc *taps,
+                   int count, int step, int n, int shift, Out *out) {
+    typedef typename Fixed<T>::Acc Acc;
+    constexpr bool narrow = !std::is_same<Out, Acc>::value;
+    const Acc half = Acc(1) << (shift - 1), top = std::numeric_limits<T>::max();
+    int e = 0;
+#if defined(__GNUC__)
+    typedef typename Fixed<T>::Lanes Lanes;
+    constexpr int lanes = sizeof(Lanes) / sizeof(Acc);
+    for (; e + lanes <= n; e += lanes) {
+        Lanes acc = Lanes{} + half;
+        for (int t = 0; t < rowCount; ++t) {
+            const Acc *src = rows[t] + e;
+            const Acc *tap = taps + static_cast<size_t>(t) * count;
+            for (int j = 0; j < count; ++j) {
+                Lanes v;
+                std::memcpy(&v, src + j * step, sizeof(v));
+                acc += tap[j] * v;
+            }
+        }
+        acc >>= shift;
+        if constexpr (narrow) {
+            acc = acc < 0 ? Lanes{} : acc;
+            acc = acc > top ? Lanes{} + top : acc;
+            auto packed = __builtin_convertvector(acc, typename Fixed<T>::Narrow);
+            std::memcpy(out + e, &packed, sizeof(packed));
+        } else {
+            std::memcpy(out + e, &acc, sizeof(acc));
+        }
+    }
+#endif
+    for (; e < n; ++e) {
+        Acc acc = half;
+        for (int t = 0; t < rowCount; ++t) {
+            for (int j = 0; j < count; ++j) acc += taps[static_cast<size_t>(t) * count + j] * rows[t][e + j * step];
+        }
+        acc >>= shift;
+        if constexpr (narrow) acc = std::min(std::max(acc, Acc(0)), top);
+        out[e] = static_cast<Out>(acc);
+    }
+}
+
+// Jak loadTile dla Image, dla próbek całkowitych z przeplecionymi kanałami,
+// rozszerzanych przy kopiowaniu do typu akumulatora
+template <BorderMode B, typename T, typename A>
+void loadTile(const PixelImage<T> &in, int x0, int y0, int tw, int th, int r, A *dst) {
+    const int c = in.channels, ls = (tw + 2 * r) * c;
+    const int xa = std::max(0, x0 - r), xb = std::min(in.width, x0 + tw + r);
+    auto put = [&](const T *src, int x, A *d) {
+        int sx = Border<B>::index(x, in.width);
+        for (int ch = 0; ch < c; ++ch) d[(x - x0 + r) * c + ch] = sx < 0 ? 0 : src[sx * c + ch];
+    };
+    for (int t = 0; t < th + 2 * r; ++t) {
+        A *d = dst + static_cast<size_t>(t) * ls;
+        int sy = Border<B>::index(y0 - r + t, in.height);
+        if (sy < 0) {
+            std::fill(d, d + ls, A(0));
+            continue;
+        }
+        const T *src = in.row(sy);
+        for (int x = x0 - r; x < xa; ++x) put(src, x, d);
+        std::copy(src + xa * c, src + xb * c, d + (xa - x0 + r) * c);
+        for (int x = xb; x < x0 + tw + r; ++x) put(src, x, d);
+    }
+}
+
+// Bufory jednego wątku dla akumulatora typu A
+template <typename A>
+struct FixedScratch {
+    std::vector<A> tile, mid;
+    std::vector<const A *> rows;
+};
+
+template <typename A>
+FixedScratch<A> &fixedScratch() {
+    thread_local FixedScratch<A> scratch;
+    return scratch;
+}
+
+template <BorderMode B, typename T>
+void blurFixedTile(const PixelImage<T> &in, PixelImage<T> &out, const FixedKernel<T> &kernel, int x0, int y0,
+                   int tw, int th) {
+    typedef typename Fixed<T>::Acc Acc;
+    const int c = in.channels, r = kernel.radius, k = kernel.size;
+    const int ls = (tw + 2 * r) * c, n = tw * c;
+    FixedScratch<Acc> &s = fixedScratch<Acc>();
+    s.tile.resize(static_cast<size_t>(th + 2 * r) * ls);
+    loadTile<B>(in, x0, y0, tw, th, r, s.tile.data());
+    s.rows.resize(k);
+
+    if (kernel.separable) {
+        // Po przebiegu poziomym wartości mają kMidFraction bitów ułamka
+        constexpr int mid = Fixed<T>::kMidFraction;
+        s.mid.resize(static_cast<size_t>(th + 2 * r) * n);
+        for (int t = 0; t < th + 2 * r; ++t) {
+            const Acc *src = s.tile.data() + static_cast<size_t>(t) * ls;
+            convolveFixed<T>(&src, 1, kernel.row.data(), k, c, n, kernel.rowShift - mid,
+                             s.mid.data() + static_cast<size_t>(t) * n);
+        }
+        for (int y = 0; y < th; ++y) {
+            for (int t = 0; t < k; ++t) s.rows[t] = s.mid.data() + static_cast<size_t>(y + t) * n;
+            convolveFixed<T>(s.rows.data(), k, kernel.column.data(), 1, 0, n, kernel.columnShift + mid,
+                             out.row(y0 + y) + x0 * c);
+        }
+        return;
+    }
+
+    for (int y = 0; y < th; ++y) {
+        for (int t = 0; t < k; ++t) s.rows[t] = s.tile.data() + static_cast<size_t>(y + t) * ls;
+        convolveFixed<T>(s.rows.data(), k, kernel.taps.data(), k, c, n, kernel.tapShift, out.row(y0 + y) + x0 * c);
+    }
+}
+
+template <typename T>
+void blurFixed(const PixelImage<T> &input, PixelImage<T> &output, const BlurKernel &kernel,
+               const BlurOptions &options, WorkerPool &pool) {
+    if (input.width != output.width || input.height != output.height || input.channels != output.channels) {
+        throw std::invalid_argument("Output image must have the size and channels of the input.");
+    }
+    if (&input == &output) throw std::invalid_argument("Blur cannot run in place.");
+    if (input.empty()) return;
+    const FixedKernel<T> fixed(kernel);
+    TileGrid grid(input.width, input.height, options);
+    withBorder(options.border, [&](auto b) {
+        pool.parallelFor(grid.count(), [&](int t, int) {
+            int x0 = t % grid.columns * grid.tileWidth;
+            int y0 = t / grid.columns * grid.tileHeight;
+            blurFixedTile<decltype(b)::value>(input, output, fixed, x0, y0,
+                                              std::min(grid.tileWidth, input.width - x0),
+                                              std::min(grid.tileHeight, input.height - y0));
+        });
+    });
+}
+
+} // namespace
+
+BlurKernel makeBlurKernel(const std::vector<std::vector<double>> &kernel, bool normalize, double tolerance) {
+    int k = static_cast<int>(kernel.size());
+    if (k == 0 || k % 2 == 0) throw std::invalid_argument("Kernel size must be odd.");
+    for (const auto &r : kernel) {
+        if (static_cast<int>(r.size()) != k) throw std::invalid_argument("Kernel must be square.");
+    }
+
+    BlurKernel out;
+    out.size = k;
+    out.radius = k / 2;
+    out.taps.reserve(static_cast<size_t>(k) * k);
+    double sum = 0.0;
+    for (const auto &r : kernel) {
+        for (double v : r) {
+            out.taps.push_back(v);
+            sum += v;
+        }
+    }
+    if (normalize) {
+        if (sum == 0.0) throw std::invalid_argument("Kernel sums to zero and cannot be normalized.");
+        for (double &v : out.taps) v /= sum;
+    }
+
+    // Rząd 1: k[i][j] = k[i][q] * k[p][j] / k[p][q] dla największego |k[p][q]|
+    auto at = [&out, k](int i, int j) { return out.taps[static_cast<size_t>(i) * k + j]; };
+    int p = 0, q = 0;
+    for (int i = 0; i < k; ++i) {
+        for (int j = 0; j < k; ++j) {
+            if (std::fabs(at(i, j)) > std::fabs(at(p, q))) {
+                p = i;
+                q = j;
+            }
+        }
+    }
+    double pivot = at(p, q);
+    if (pivot == 0.0) return out;
+    std::vector<double> column(k), row(k);
+    for (int i = 0; i < k; ++i) column[i] = at(i, q);
+    for (int j = 0; j < k; ++j) row[j] = at(p, j) / pivot;
+    for (int i = 0; i < k; ++i) {
+        for (int j = 0; j < k; ++j) {
+            if (std::fabs(at(i, j) - column[i] * row[j]) > tolerance * std::fabs(pivot)) return out;
+        }
+    }
+    out.separable = true;
+    out.column.swap(column);
+    out.row.swap(row);
+    return out;
+}
+
+BlurKernel gaussianKernel(double sigma, double truncate) {
+    if (!(sigma > 0.0)) throw std::invalid_argument("Sigma must be positive.");
+    int radius = std::max(1, static_cast<int>(std::ceil(truncate * sigma)));
+    int k = 2 * radius + 1;
+    // Tap i = masa Gaussa nad pikselem [i - 1/2, i + 1/2], a nie wartość w
+    // jego środku: przy małym sigma próbkowanie punktowe zaniża rozmycie
+    std::vector<double> g(k);
+    const double scale = 1.0 / (std::sqrt(2.0) * sigma);
+    double sum = 0.0;
+    for (int i = 0; i < k; ++i) {
+        double d = i - radius;
+        g[i] = 0.5 * (std::erf((d + 0.5) * scale) - std::erf((d - 0.5) * scale));
+        sum += g[i];
+    }
+    for (double &v : g) v /= sum;
+
+    BlurKernel out;
+    out.size = k;
+    out.radius = radius;
+    out.taps.resize(static_cast<size_t>(k) * k);
+    for (int i = 0; i < k; ++i) {
+        for (int j = 0; j < k; ++j) out.taps[static_cast<size_t>(i) * k + j] = g[i] * g[j];
+    }
+    out.separable = true;
+    out.column = g;
+    out.row = g;
+    return out;
+}
+
+void blurImage(const Image &input, Image &output, const BlurKernel &kernel, const BlurOptions &options,
+               WorkerPool &pool) {
+    checkSizes(input, output);
+    if (input.empty()) return;
+    TileGrid grid(input.width, input.height, options);
+    withBorder(options.border, [&](auto b) {
+        pool.parallelFor(grid.count(), [&](int t, int) { blurTileAt<decltype(b)::value>(input, output, kernel, grid, t); });
+    });
+}
+
+Image blur(const Image &input, const BlurKernel &kernel, const BlurOptions &options) {
+    Image output(input.width, input.height);
+    if (input.empty()) return output;
+    TileGrid grid(input.width, input.height, options);
+    withBorder(options.border, [&](auto b) {
+        for (int t = 0; t < grid.count(); ++t) blurTileAt<decltype(b)::value>(input, output, kernel, grid, t);
+    });
+    return output;
+}
+
+void blurStream(RasterReader &input, RasterWriter &output, const BlurKernel &kernel, BorderMode border,
+                int blockRows) {
+    const RasterInfo &in = input.info(), &out = output.info();
+    if (in.width != out.width || in.height != out.height) {
+        throw std::invalid_argument("Output image must have the size of the input.");
+    }
+    blockRows = std::max(1, blockRows);
+    withBorder(border, [&](auto b) { blurStreamRows<decltype(b)::value>(input, output, kernel, blockRows); });
+}
+
+void gaussianBlur(const Image &input, Image &output, double sigma, const BlurOptions &options, WorkerPool &pool,
+                  BlurMethod method) {
+    checkSizes(input, output);
+    if (!(sigma > 0.0)) throw std::invalid_argument("Sigma must be positive.");
+    if (method == BlurMethod::Auto) method = sigma < kRecursiveMinSigma ? BlurMethod::Fir : BlurMethod::Recursive;
+    if (method == BlurMethod::Fir) {
+        blurImage(input, output, gaussianKernel(sigma), options, pool);
+        return;
+    }
+    if (sigma < 0.5) throw std::invalid_argument("Recursive Gaussian needs sigma >= 0.5.");
+    if (input.empty()) return;
+
+    RecursiveGauss g(sigma);
+    const int strip = std::max(4, options.tileWidth / 4 * 4);
+    const int strips = (input.width + strip - 1) / strip;
+    withBorder(options.border, [&](auto b) {
+        constexpr BorderMode B = decltype(b)::value;
+        pool.parallelFor((input.height + 3) / 4, [&](int t, int) { recursiveRows<B>(input, output, g, 4 * t); });
+        pool.parallelFor(strips, [&](int t, int) {
+            recursiveColumns<B>(output, g, t * strip, std::min(strip, input.width - t * strip));
+        });
+    });
+}
+
+Image gaussianBlur(const Image &input, double sigma, const BlurOptions &options, BlurMethod method) {
+    Image output(input.width, input.height);
+    gaussianBlur(input, output, sigma, options, WorkerPool::shared(1), method);
+    return output;
+}
+
+void blurImage(const Image8 &input, Image8 &output, const BlurKernel &kernel, const BlurOptions &options,
+               WorkerPool &pool) {
+    blurFixed(input, output, kernel, options, pool);
+}
+
+void blurImage(const Image16 &input, Image16 &output, const BlurKernel &kernel, const BlurOptions &options,
+               WorkerPool &pool) {
+    blurFixed(input, output, kernel, options, pool);
+}
+
+Image8 blur(const Image8 &input, const BlurKernel &kernel, const BlurOptions &options) {
+    Image8 output(input.width, input.height, input.channels);
+    blurFixed(input, output, kernel, options, WorkerPool::shared(1));
+    return output;
+}
+
+Image16 blur(const Image16 &input, const BlurKernel &kernel, const BlurOptions &options) {
+    Image16 output(input.width, input.height, input.channels);
+    blurFixed(input, output, kernel, options, WorkerPool::shared(1));
+    return output;
+}
@@ -0,0 +1,100 @@
+#include "src_image.h"
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+Image::Image(int w, int h, int s) : width(w), height(h) {
+    if (w < 0 || h < 0) throw std::invalid_argument("Image size must be >= 0.");
+    if (s != 0 && s < w) throw std::invalid_argument("Image stride must be >= width.");
+    stride = (std::max(s, w) + kRowAlign - 1) / kRowAlign * kRowAlign;
+    size_t bytes = static_cast<size_t>(stride) * h * sizeof(double);
+    if (bytes == 0) return;
+    void *p = std::aligned_alloc(kAlignment, bytes);
+    if (!p) throw std::bad_alloc();
+    std::memset(p, 0, bytes);
+    data_.reset(static_cast<double *>(p));
+}
+
+Image::Image(const Image &other) : Image(other.width, other.height, other.stride) {
+    if (data_) std::memcpy(data_.get(), other.data_.get(), static_cast<size_t>(stride) * height * sizeof(double));
+}
+
+Image::Image(Image &&other) noexcept
+    : width(std::exchange(other.width, 0)), height(std::exchange(other.height, 0)),
+      stride(std::exchange(other.stride, 0)), data_(std::move(other.data_)) {}
+
+Image &Image::operator=(Image other) noexcept {
+    std::swap(width, other.width);
+    std::swap(height, other.height);
+    std::swap(stride, other.stride);
+    std::swap(data_, other.data_);
+    return *this;
+}
+
+Image Image::fromRows(const std::vector<std::vector<double>> &rows) {
+    int h = static_cast<int>(rows.size());
+    int w = h > 0 ? static_cast<int>(rows[0].size()) : 0;
+    Image img(w, h);
+    for (int y = 0; y < h; ++y) {
+        if (static_cast<int>(rows[y].size()) != w) throw std::invalid_argument("Image rows must have equal length.");
+        std::copy(rows[y].begin(), rows[y].end(), img.row(y));
+    }
+    return img;
+}
+
+std::vector<std::vector<double>> Image::toRows() const {
+    std::vector<std::vector<double>> rows(height);
+    for (int y = 0; y < height; ++y) rows[y].assign(row(y), row(y) + width);
+    return rows;
+}
+
+template <typename T>
+PixelImage<T>::PixelImage(int w, int h, int c, int s) : width(w), height(h), channels(c) {
+    if (w < 0 || h < 0) throw std::invalid_argument("Image size must be >= 0.");
+    if (c < 1) throw std::invalid_argument("Image must have at least one channel.");
+    if (s != 0 && s < w * c) throw std::invalid_argument("Image stride must be >= width * channels.");
+    stride = (std::max(s, w * c) + kRowAlign - 1) / kRowAlign * kRowAlign;
+    size_t bytes = static_cast<size_t>(stride) * h * sizeof(T);
+    if (bytes == 0) return;
+    void *p = std::aligned_alloc(kAlignment, bytes);
+    if (!p) throw std::bad_alloc();
+    std::memset(p, 0, bytes);
+    data_.reset(static_cast<T *>(p));
+}
+
+template <typename T>
+PixelImage<T>::PixelImage(const PixelImage &other)
+    : PixelImage(other.width, other.height, other.channels, other.stride) {
+    if (data_) std::memcpy(data_.get(), other.data_.get(), static_cast<size_t>(stride) * height * sizeof(T));
+}
+
+template <typename T>
+PixelImage<T>::PixelImage(PixelImage &&other) noexcept
+    : width(std::exchange(other.width, 0)), height(std::exchange(other.height, 0)),
+      channels(std::exchange(other.channels, 1)), stride(std::exchange(other.stride, 0)),
+      data_(std::move(other.data_)) {}
+
+template <typename T>
+PixelImage<T> &PixelImage<T>::operator=(PixelImage other) noexcept {
+    std::swap(width, other.width);
+    std::swap(height, other.height);
+    std::swap(channels, other.channels);
+    std::swap(stride, other.stride);
+    std::swap(data_, other.data_);
+    return *this;
+}
+
+template <typename T>
+Image PixelImage<T>::channel(int c) const {
+    if (c < 0 || c >= channels) throw std::out_of_range("Channel index out of range.");
+    Image img(width, height);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) img.at(x, y) = at(x, y, c);
+    }
+    return img;
+}
+
+template class PixelImage<uint8_t>;
+template class PixelImage<uint16_t>;
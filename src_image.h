@@ -0,0 +1,92 @@
+#ifndef SRC_IMAGE_H
+#define SRC_IMAGE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+// Obraz w jednym ciągłym buforze: wiersz y zaczyna się od row(y), kolejne
+// wiersze są co `stride` elementów (stride >= width). Każdy wiersz zaczyna
+// się na granicy 64 bajtów, a dopełnienie wiersza jest wyzerowane.
+class Image {
+public:
+    static constexpr int kAlignment = 64;                         // bajty
+    static constexpr int kRowAlign = kAlignment / sizeof(double); // elementy
+
+    int width = 0;
+    int height = 0;
+    int stride = 0;
+
+    Image() = default;
+    // stride = 0: width zaokrąglone w górę do kRowAlign; podany stride też
+    // jest zaokrąglany, żeby wiersze zostały wyrównane
+    Image(int width, int height, int stride = 0);
+    Image(const Image &other);
+    // Źródło zostaje pustym obrazem 0 x 0
+    Image(Image &&other) noexcept;
+    Image &operator=(Image other) noexcept;
+
+    double *row(int y) { return data_.get() + static_cast<size_t>(y) * stride; }
+    const double *row(int y) const { return data_.get() + static_cast<size_t>(y) * stride; }
+
+    double &at(int x, int y) { return row(y)[x]; }
+    double at(int x, int y) const { return row(y)[x]; }
+
+    bool empty() const { return width == 0 || height == 0; }
+
+    // Konwersje z i do obrazu jako wektora wierszy
+    static Image fromRows(const std::vector<std::vector<double>> &rows);
+    std::vector<std::vector<double>> toRows() const;
+
+private:
+    struct AlignedFree {
+        void operator()(double *p) const { std::free(p); }
+    };
+    std::unique_ptr<double, AlignedFree> data_;
+};
+
+// Obraz o próbkach całkowitych (uint8_t, uint16_t) z przeplecionymi kanałami:
+// kanał c piksela (x, y) to row(y)[x * channels + c]. Wiersze wyrównane jak w
+// Image; stride liczony w próbkach (>= width * channels).
+template <typename T>
+class PixelImage {
+public:
+    static constexpr int kAlignment = Image::kAlignment;
+    static constexpr int kRowAlign = kAlignment / sizeof(T);
+
+    int width = 0;
+    int height = 0;
+    int channels = 1;
+    int stride = 0;
+
+    PixelImage() = default;
+    PixelImage(int width, int height, int channels = 1, int stride = 0);
+    PixelImage(const PixelImage &other);
+    // Źródło zostaje pustym obrazem 0 x 0 o jednym kanale
+    PixelImage(PixelImage &&other) noexcept;
+    PixelImage &operator=(PixelImage other) noexcept;
+
+    T *row(int y) { return data_.get() + static_cast<size_t>(y) * stride; }
+    const T *row(int y) const { return data_.get() + static_cast<size_t>(y) * stride; }
+
+    T &at(int x, int y, int c = 0) { return row(y)[x * channels + c]; }
+    T at(int x, int y, int c = 0) const { return row(y)[x * channels + c]; }
+
+    bool empty() const { return width == 0 || height == 0; }
+
+    // Jeden kanał jako obraz double (np. do porównań z rozmyciem zmiennoprzecinkowym)
+    Image channel(int c) const;
+
+private:
+    struct AlignedFree {
+        void operator()(T *p) const { std::free(p); }
+    };
+    std::unique_ptr<T, AlignedFree> data_;
+};
+
+using Image8 = PixelImage<uint8_t>;
+using Image16 = PixelImage<uint16_t>;
+
+#endif // SRC_IMAGE_H
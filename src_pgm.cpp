@@ -0,0 +1,110 @@
+#include "src_pgm.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+std::FILE *openFile(const std::string &path, const char *mode) {
+    std::FILE *f = std::fopen(path.c_str(), mode);
+    if (!f) throw std::runtime_error("Cannot open " + path);
+    return f;
+}
+
+// Liczba z nagłówka PGM (pomija białe znaki i komentarze "# ...")
+int readHeaderNumber(std::FILE *f, const std::string &path) {
+    int c = std::fgetc(f);
+    for (;;) {
+        while (c != EOF && std::isspace(c)) c = std::fgetc(f);
+        if (c != '#') break;
+        while (c != EOF && c != '\n') c = std::fgetc(f);
+    }
+    if (c == EOF || !std::isdigit(c)) throw std::runtime_error(path + " has a malformed PGM header");
+    long value = 0;
+    while (c != EOF && std::isdigit(c)) {
+        value = value * 10 + (c - '0');
+        if (value > 1 << 30) throw std::runtime_error(path + " has a malformed PGM header");
+        c = std::fgetc(f);
+    }
+    // Po maxval jest dokładnie jeden biały znak, potem dane
+    if (c == EOF || !std::isspace(c)) throw std::runtime_error(path + " has a malformed PGM header");
+    return static_cast<int>(value);
+}
+
+void checkInfo(const RasterInfo &info, const std::string &path) {
+    if (info.width <= 0 || info.height <= 0 || info.maxval <= 0 || info.maxval > 65535) {
+        throw std::runtime_error(path + ": unsupported image size or maxval");
+    }
+}
+
+} // namespace
+
+RasterReader::RasterReader(const std::string &path) : file_(openFile(path, "rb")), path_(path) {
+    if (std::fgetc(file_.get()) != 'P' || std::fgetc(file_.get()) != '5') {
+        throw std::runtime_error(path + " is not a binary PGM (P5) file");
+    }
+    info_.width = readHeaderNumber(file_.get(), path);
+    info_.height = readHeaderNumber(file_.get(), path);
+    info_.maxval = readHeaderNumber(file_.get(), path);
+    checkInfo(info_, path);
+}
+
+RasterReader::RasterReader(const std::string &path, const RasterInfo &info)
+    : file_(openFile(path, "rb")), path_(path), info_(info) {
+    checkInfo(info_, path);
+}
+
+void RasterReader::readRows(double *dst, int count, int stride) {
+    if (rowsRead_ + count > info_.height) throw std::runtime_error(path_ + ": read past the last row");
+    const int bps = info_.bytesPerSample();
+    std::vector<unsigned char> buf(static_cast<size_t>(info_.width) * bps);
+    for (int r = 0; r < count; ++r) {
+        if (std::fread(buf.data(), 1, buf.size(), file_.get()) != buf.size()) {
+            throw std::runtime_error(path_ + " is truncated");
+        }
+        double *d = dst + static_cast<size_t>(r) * stride;
+        if (bps == 1) {
+            for (int x = 0; x < info_.width; ++x) d[x] = buf[x];
+        } else {
+            for (int x = 0; x < info_.width; ++x) d[x] = buf[2 * x] << 8 | buf[2 * x + 1];
+        }
+    }
+    rowsRead_ += count;
+}
+
+RasterWriter::RasterWriter(const std::string &path, const RasterInfo &info, bool raw)
+    : file_(openFile(path, "wb")), path_(path), info_(info) {
+    checkInfo(info_, path);
+    if (!raw && std::fprintf(file_.get(), "P5\n%d %d\n%d\n", info.width, info.height, info.maxval) < 0) {
+        throw std::runtime_error("Cannot write " + path);
+    }
+}
+
+void RasterWriter::writeRows(const double *src, int count, int stride) {
+    if (rowsWritten_ + count > info_.height) throw std::runtime_error(path_ + ": write past the last row");
+    const int bps = info_.bytesPerSample();
+    const double top = info_.maxval;
+    std::vector<unsigned char> buf(static_cast<size_t>(info_.width) * bps);
+    for (int r = 0; r < count; ++r) {
+        const double *s = src + static_cast<size_t>(r) * stride;
+        for (int x = 0; x < info_.width; ++x) {
+            unsigned v = static_cast<unsigned>(std::min(std::max(std::round(s[x]), 0.0), top));
+            if (bps == 1) {
+                buf[x] = static_cast<unsigned char>(v);
+            } else {
+                buf[2 * x] = static_cast<unsigned char>(v >> 8);
+                buf[2 * x + 1] = static_cast<unsigned char>(v);
+            }
+        }
+        if (std::fwrite(buf.data(), 1, buf.size(), file_.get()) != buf.size()) {
+            throw std::runtime_error("Cannot write " + path_);
+        }
+    }
+    rowsWritten_ += count;
+}
+
+void RasterWriter::flush() {
+    if (std::fflush(file_.get()) != 0) throw std::runtime_error("Cannot write " + path_);
+}
@@ -0,0 +1,66 @@
+#ifndef SRC_PGM_H
+#define SRC_PGM_H
+
+#include <cstdio>
+#include <memory>
+#include <string>
+
+// Obrazy w skali szarości w pliku, czytane i zapisywane po kilka wierszy, bez
+// trzymania całego obrazu w pamięci.
+//
+// PGM (P5): nagłówek "P5 szerokość wysokość maxval", potem próbki wierszami,
+// 1 bajt gdy maxval < 256, inaczej 2 bajty big-endian. Plik "raw" to same
+// próbki w tym samym układzie, bez nagłówka; wymiary i maxval podaje się z ręki.
+struct RasterInfo {
+    int width = 0;
+    int height = 0;
+    int maxval = 255; // 1..65535
+
+    int bytesPerSample() const { return maxval < 256 ? 1 : 2; }
+};
+
+class RasterReader {
+public:
+    // PGM; rzuca std::runtime_error dla brakującego lub błędnego pliku
+    explicit RasterReader(const std::string &path);
+    // Raw o podanych wymiarach
+    RasterReader(const std::string &path, const RasterInfo &info);
+
+    const RasterInfo &info() const { return info_; }
+
+    // Następne `count` wierszy do dst (wiersz co `stride` elementów)
+    void readRows(double *dst, int count, int stride);
+
+private:
+    struct FileClose {
+        void operator()(std::FILE *f) const { std::fclose(f); }
+    };
+    std::unique_ptr<std::FILE, FileClose> file_;
+    std::string path_;
+    RasterInfo info_;
+    int rowsRead_ = 0;
+};
+
+class RasterWriter {
+public:
+    // raw = false: PGM z nagłówkiem; wartości są zaokrąglane i obcinane do [0, maxval]
+    RasterWriter(const std::string &path, const RasterInfo &info, bool raw = false);
+
+    const RasterInfo &info() const { return info_; }
+
+    void writeRows(const double *src, int count, int stride);
+
+    // Wypchnięcie buforów; rzuca std::runtime_error, gdy zapis się nie udał
+    void flush();
+
+private:
+    struct FileClose {
+        void operator()(std::FILE *f) const { std::fclose(f); }
+    };
+    std::unique_ptr<std::FILE, FileClose> file_;
+    std::string path_;
+    RasterInfo info_;
+    int rowsWritten_ = 0;
+};
+
+#endif // SRC_PGM_H
@@ -0,0 +1,78 @@
+#include "src_pool.h"
+#include <map>
+#include <memory>
+
+WorkerPool::WorkerPool(int threadCount) {
+    for (int w = 1; w < threadCount; ++w) workers_.emplace_back(&WorkerPool::workerLoop, this, w);
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    for (auto &t : workers_) t.join();
+}
+
+void WorkerPool::runTasks(int worker) {
+    for (;;) {
+        int t = next_.fetch_add(1, std::memory_order_relaxed);
+        if (t >= taskCount_) return;
+        try {
+            (*task_)(t, worker);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!error_) error_ = std::current_exception();
+            // Pozostałe zadania nie mają już sensu
+            next_.store(taskCount_, std::memory_order_relaxed);
+        }
+    }
+}
+
+void WorkerPool::workerLoop(int worker) {
+    unsigned seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [&] { return stop_ || round_ != seen; });
+            if (stop_) return;
+            seen = round_;
+        }
+        runTasks(worker);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (--busy_ == 0) done_.notify_one();
+        }
+    }
+}
+
+void WorkerPool::parallelFor(int taskCount, const std::function<void(int, int)> &task) {
+    if (taskCount <= 0) return;
+    std::lock_guard<std::mutex> run(runMutex_);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        task_ = &task;
+        taskCount_ = taskCount;
+        next_.store(0, std::memory_order_relaxed);
+        busy_ = static_cast<int>(workers_.size());
+        error_ = nullptr;
+        ++round_;
+    }
+    wake_.notify_all();
+    runTasks(0);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [this] { return busy_ == 0; });
+    task_ = nullptr;
+    if (error_) std::rethrow_exception(error_);
+}
+
+WorkerPool &WorkerPool::shared(int threadCount) {
+    static std::mutex m;
+    static std::map<int, std::unique_ptr<WorkerPool>> pools;
+    std::lock_guard<std::mutex> lock(m);
+    std::unique_ptr<WorkerPool> &pool = pools[threadCount];
+    if (!pool) pool.reset(new WorkerPool(threadCount));
+    return *pool;
+}
@@ -0,0 +1,52 @@
+#ifndef SRC_POOL_H
+#define SRC_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Stała pula wątków: wątki powstają raz, a nie przy każdym wywołaniu.
+//
+// parallelFor() rozdaje zadania dynamicznie (wspólny licznik atomowy), więc
+// wątek, który skończy wcześniej, bierze następne zadanie; wątek wywołujący
+// też pracuje (jest wątkiem 0). Zadań może być mniej niż wątków.
+class WorkerPool {
+public:
+    explicit WorkerPool(int threadCount);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool &) = delete;
+    WorkerPool &operator=(const WorkerPool &) = delete;
+
+    int size() const { return static_cast<int>(workers_.size()) + 1; }
+
+    // task(t, worker) dla t w [0, taskCount), worker w [0, size()); czeka na
+    // wszystkie zadania i rzuca dalej pierwszy wyjątek któregoś z nich
+    void parallelFor(int taskCount, const std::function<void(int, int)> &task);
+
+    // Wspólna pula o dokładnie threadCount wątkach, tworzona przy pierwszym użyciu
+    static WorkerPool &shared(int threadCount);
+
+private:
+    void workerLoop(int worker);
+    void runTasks(int worker);
+
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    std::mutex runMutex_; // jedno parallelFor naraz
+    const std::function<void(int, int)> *task_ = nullptr;
+    int taskCount_ = 0;
+    std::atomic<int> next_{0};
+    int busy_ = 0;         // wątki, które jeszcze nie skończyły bieżącej rundy
+    unsigned round_ = 0;
+    bool stop_ = false;
+    std::exception_ptr error_;
+};
+
+#endif // SRC_POOL_H